@@ -0,0 +1,609 @@
+// ============================================================================================
+//
+// affinity.cpp -- Thread Affinity and CPU Placement
+//
+// ============================================================================================
+
+/*
+This source file defines the routines that pin threads to CPUs and nodes and suggest where to
+place them.  See "affinity.h" for details.
+*/
+
+// ============================================================================================
+// DESIGN NOTES
+// ============================================================================================
+
+/*
+The placement is worked out once, as a list of every usable CPU in the order in which they
+should be handed out.  Each CPU is given a "rank" -- the number of lower-numbered CPUs on the
+same core -- and the list is sorted by rank, then package, then core, so that rank 0 (one
+hardware thread per core) comes first.
+
+On Linux, the usable CPUs are the online ones ("/sys/devices/system/cpu/online") that are also
+in the process's affinity mask, so a program started with "taskset" (or in a container with a
+CPU limit) only places workers on the CPUs that it was given.  Each CPU's package and core
+numbers are read from its "topology" directory; a CPU whose numbers can't be read is treated
+as a core of its own.  Pinning calls "sched_setaffinity()" for the calling thread (thread ID
+0), which is what "pthread_setaffinity_np()" does too.
+
+On Windows, "GetLogicalProcessorInformation()" lists each core with a mask of its logical
+processors, in package order, so the n'th bit of each core's mask has rank n.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+#include "platform/affinity.h"
+
+#if defined(__linux__)
+  #define AFFINITY_LINUX
+  #include <sched.h>
+  #include <unistd.h>
+#elif defined(_WIN32)
+  #define AFFINITY_WIN32
+  #include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+  #include <unistd.h>
+#endif
+
+// ============================================================================================
+// PRIVATE MACRO DEFINITIONS
+// ============================================================================================
+
+// The highest number of CPUs that's supported (glibc's "CPU_SETSIZE")
+
+#define AFFINITY_MAX_CPUS 1024
+
+#define AFFINITY_BITS_PER_WORD (8 * sizeof(unsigned long))
+#define AFFINITY_MASK_WORDS    (AFFINITY_MAX_CPUS / AFFINITY_BITS_PER_WORD)
+
+// Tests and sets a CPU's bit in a mask of "AFFINITY_MASK_WORDS" words
+
+#define AFFINITY_ISSET(cpu, mask) \
+  (((mask)[(cpu) / AFFINITY_BITS_PER_WORD] >> ((cpu) % AFFINITY_BITS_PER_WORD)) & 1UL)
+#define AFFINITY_SET(cpu, mask) \
+  ((mask)[(cpu) / AFFINITY_BITS_PER_WORD] |= 1UL << ((cpu) % AFFINITY_BITS_PER_WORD))
+
+// ============================================================================================
+// PRIVATE TYPE DEFINITIONS
+// ============================================================================================
+
+// A CPU's position in the topology
+
+struct AffinityCpu
+{
+  int cpu;                                                                        // its number
+  int rank;                                    // the number of lower-numbered CPUs on its core
+  int package;                                                   // its package (socket) number
+  int core;                                                   // its core number in the package
+};
+
+// ============================================================================================
+// PRIVATE FUNCTION DECLARATIONS
+// ============================================================================================
+
+static int  detectTopology(void);
+static void sortCpus(AffinityCpu*, const int);
+
+#if defined(AFFINITY_LINUX)
+  static int  parseCpuList(const char*, unsigned long*);
+  static int  readCpuList(const char*, unsigned long*);
+  static int  readNumber(const char*, const int);
+  static int  pinToMask(const unsigned long*);
+#endif
+
+// ============================================================================================
+// STATIC VARIABLE DEFINITIONS
+// ============================================================================================
+
+static int topologyDetected = 0;                           // non-zero once "cpuCount" is valid
+static int placement[AFFINITY_MAX_CPUS];           // the usable CPUs, in the order to use them
+static int cpuCount         = detectTopology();            // the number of CPUs in "placement"
+
+// ============================================================================================
+// FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+int pf_cpu_count(void)
+
+/*
+This function determines how many CPUs the program can use.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The number of CPUs is returned (at least 1).
+*/
+
+{
+  if (!topologyDetected)
+    cpuCount = detectTopology();
+
+  return cpuCount;
+}
+
+/*********************************************************************************************/
+
+int pf_cpu_placement
+(
+  int*      cpus,                                             // receives a CPU for each worker
+  const int count                                                      // the number of workers
+)
+
+/*
+This function suggests which CPU each of a set of worker threads should be pinned to.
+
+PRECONDITIONS:
+"cpus" must have room for "count" numbers.
+
+POSTCONDITIONS:
+"cpus[i]" is the CPU for worker "i", ordered as described in "affinity.h".  The number of
+CPUs that the program can use is returned.
+*/
+
+{
+  const int usable = pf_cpu_count();
+  int       index;
+
+  for (index = 0; index < count; index++)
+    cpus[index] = placement[index % usable];
+
+  return usable;
+}
+
+/*********************************************************************************************/
+
+int pf_thread_pin
+(
+  const int cpu                                                               // the CPU to use
+)
+
+/*
+This function restricts the calling thread to a single CPU.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+Non-zero is returned if the thread is now pinned to "cpu", or 0 if it couldn't be.
+*/
+
+{
+  if ((cpu < 0) || (cpu >= AFFINITY_MAX_CPUS))
+    return 0;
+
+  #if defined(AFFINITY_LINUX)
+
+    unsigned long mask[AFFINITY_MASK_WORDS];
+
+    memset(mask, 0, sizeof(mask));
+    AFFINITY_SET(cpu, mask);
+    return pinToMask(mask);
+
+  #elif defined(AFFINITY_WIN32)
+
+    if (cpu >= (int)(8 * sizeof(DWORD_PTR)))
+      return 0;
+
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+
+  #else
+
+    return 0;
+
+  #endif
+}
+
+/*********************************************************************************************/
+
+int pf_thread_pin_node
+(
+  const int node                                                             // the node to use
+)
+
+/*
+This function restricts the calling thread to the CPUs of one NUMA node.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+Non-zero is returned if the thread is now restricted to the CPUs of "node", or 0 if it
+couldn't be (it's then unchanged).
+*/
+
+{
+  if (node < 0)
+    return 0;
+
+  #if defined(AFFINITY_LINUX)
+
+    char          path[64];
+    unsigned long mask[AFFINITY_MASK_WORDS];
+
+    sprintf(path, "/sys/devices/system/node/node%d/cpulist", node);
+
+    if (readCpuList(path, mask) == 0)
+      return 0;
+
+    return pinToMask(mask);
+
+  #elif defined(AFFINITY_WIN32)
+
+    ULONGLONG mask;
+
+    if ((node > 0xFF) || !GetNumaNodeProcessorMask((UCHAR)node, &mask) || (mask == 0))
+      return 0;
+
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)mask) != 0;
+
+  #else
+
+    return 0;
+
+  #endif
+}
+
+// ============================================================================================
+// PRIVATE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+static int detectTopology(void)
+
+/*
+This function reads the CPU topology and fills in "placement".
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The number of CPUs in "placement" is returned (at least 1).
+*/
+
+{
+  static AffinityCpu cpus[AFFINITY_MAX_CPUS];
+  int                count = 0;
+  int                index;
+
+  #if defined(AFFINITY_LINUX)
+
+    unsigned long online[AFFINITY_MASK_WORDS];
+    cpu_set_t     allowed;
+    const int     restricted = (sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    int           cpu;
+
+    if (readCpuList("/sys/devices/system/cpu/online", online) > 0)
+    {
+      for (cpu = 0; cpu < AFFINITY_MAX_CPUS; cpu++)
+      {
+        char path[96];
+        int  other;
+
+        if (!AFFINITY_ISSET(cpu, online) ||
+            (restricted && (cpu < CPU_SETSIZE) && !CPU_ISSET(cpu, &allowed)))
+        {
+          continue;
+        }
+
+        cpus[count].cpu = cpu;
+
+        sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        cpus[count].package = readNumber(path, 0);
+
+        sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+        cpus[count].core = readNumber(path, -1 - cpu);
+
+        cpus[count].rank = 0;
+
+        for (other = 0; other < count; other++)
+        {
+          if ((cpus[other].package == cpus[count].package) &&
+              (cpus[other].core == cpus[count].core))
+          {
+            cpus[count].rank++;
+          }
+        }
+
+        count++;
+      }
+    }
+
+  #elif defined(AFFINITY_WIN32)
+
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION* info   = NULL;
+    DWORD                                 length = 0;
+
+    if (!GetLogicalProcessorInformation(NULL, &length) &&
+        (GetLastError() == ERROR_INSUFFICIENT_BUFFER))
+    {
+      info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION*)malloc(length);
+    }
+
+    if ((info != NULL) && GetLogicalProcessorInformation(info, &length))
+    {
+      const DWORD entries = length / sizeof(*info);
+      DWORD       entry;
+      int         core    = 0;
+
+      for (entry = 0; entry < entries; entry++)
+      {
+        if (info[entry].Relationship == RelationProcessorCore)
+        {
+          ULONG_PTR bits = info[entry].ProcessorMask;
+          int       rank = 0;
+          int       cpu;
+
+          for (cpu = 0; (bits != 0) && (count < AFFINITY_MAX_CPUS); cpu++, bits >>= 1)
+          {
+            if (bits & 1)
+            {
+              cpus[count].cpu     = cpu;
+              cpus[count].rank    = rank++;
+              cpus[count].package = 0;
+              cpus[count].core    = core;
+              count++;
+            }
+          }
+
+          core++;
+        }
+      }
+    }
+
+    free(info);
+
+  #endif
+
+  if (count == 0)                                        // list every CPU as a core of its own
+  {
+    long total = 1;
+
+    #if defined(AFFINITY_WIN32)
+      SYSTEM_INFO system;
+
+      GetSystemInfo(&system);
+      total = (long)system.dwNumberOfProcessors;
+    #elif defined(_SC_NPROCESSORS_ONLN)
+      total = sysconf(_SC_NPROCESSORS_ONLN);
+    #endif
+
+    if (total > AFFINITY_MAX_CPUS)
+      total = AFFINITY_MAX_CPUS;
+
+    for (count = 0; count < total; count++)
+    {
+      cpus[count].cpu     = count;
+      cpus[count].rank    = 0;
+      cpus[count].package = 0;
+      cpus[count].core    = count;
+    }
+
+    if (count == 0)
+    {
+      cpus[0].cpu = 0;
+      count       = 1;
+    }
+  }
+
+  sortCpus(cpus, count);
+
+  for (index = 0; index < count; index++)
+    placement[index] = cpus[index].cpu;
+
+  topologyDetected = 1;
+  return count;
+}
+
+/*********************************************************************************************/
+
+static void sortCpus
+(
+  AffinityCpu* cpus,                                                        // the CPUs to sort
+  const int    count                                                      // the number of CPUs
+)
+
+/*
+This function sorts CPUs by rank, then package, then core (then CPU number).
+
+PRECONDITIONS:
+"cpus" must point to "count" CPUs.
+
+POSTCONDITIONS:
+The CPUs are sorted.
+*/
+
+{
+  int index;
+
+  for (index = 1; index < count; index++)                                  // an insertion sort
+  {
+    const AffinityCpu moving = cpus[index];
+    int               slot   = index;
+
+    while ((slot > 0) &&
+           ((cpus[slot - 1].rank > moving.rank) ||
+            ((cpus[slot - 1].rank == moving.rank) &&
+             ((cpus[slot - 1].package > moving.package) ||
+              ((cpus[slot - 1].package == moving.package) &&
+               (cpus[slot - 1].core > moving.core))))))
+    {
+      cpus[slot] = cpus[slot - 1];
+      slot--;
+    }
+
+    cpus[slot] = moving;
+  }
+}
+
+/*********************************************************************************************/
+
+#if defined(AFFINITY_LINUX)
+
+static int parseCpuList
+(
+  const char*    list,                                           // a list such as "0-3,8-11\n"
+  unsigned long* mask                                     // receives a bit for each listed CPU
+)
+
+/*
+This function parses a Linux CPU list.
+
+PRECONDITIONS:
+"list" and "mask" must not be NULL, and "mask" must have room for "AFFINITY_MAX_CPUS" bits.
+
+POSTCONDITIONS:
+The number of CPUs listed is returned, or 0 if the list is empty or malformed.  Numbers of
+"AFFINITY_MAX_CPUS" or more are ignored.
+*/
+
+{
+  int listed = 0;
+
+  memset(mask, 0, AFFINITY_MASK_WORDS * sizeof(unsigned long));
+
+  while ((*list >= '0') && (*list <= '9'))
+  {
+    int first = 0;
+    int last;
+
+    while ((*list >= '0') && (*list <= '9') && (first < AFFINITY_MAX_CPUS))
+      first = (first * 10) + (*list++ - '0');
+
+    last = first;
+
+    if (*list == '-')
+    {
+      list++;
+      last = 0;
+
+      while ((*list >= '0') && (*list <= '9') && (last < AFFINITY_MAX_CPUS))
+        last = (last * 10) + (*list++ - '0');
+    }
+
+    for (; (first <= last) && (first < AFFINITY_MAX_CPUS); first++)
+    {
+      AFFINITY_SET(first, mask);
+      listed++;
+    }
+
+    if (*list == ',')
+      list++;
+  }
+
+  return listed;
+}
+
+/*********************************************************************************************/
+
+static int readCpuList
+(
+  const char*    path,                                              // the file to read it from
+  unsigned long* mask                                     // receives a bit for each listed CPU
+)
+
+/*
+This function reads a Linux CPU list from a file.
+
+PRECONDITIONS:
+"path" and "mask" must not be NULL, and "mask" must have room for "AFFINITY_MAX_CPUS" bits.
+
+POSTCONDITIONS:
+The number of CPUs listed is returned, or 0 if the file couldn't be read.
+*/
+
+{
+  FILE* file   = fopen(path, "r");
+  int   listed = 0;
+  char  list[1024];
+
+  memset(mask, 0, AFFINITY_MASK_WORDS * sizeof(unsigned long));
+
+  if (file != NULL)
+  {
+    if (fgets(list, sizeof(list), file) != NULL)
+      listed = parseCpuList(list, mask);
+
+    fclose(file);
+  }
+
+  return listed;
+}
+
+/*********************************************************************************************/
+
+static int readNumber
+(
+  const char* path,                                                 // the file to read it from
+  const int   fallback                                 // the number to use if it can't be read
+)
+
+/*
+This function reads a decimal number from a file.
+
+PRECONDITIONS:
+"path" must not be NULL.
+
+POSTCONDITIONS:
+The number is returned, or "fallback" if the file couldn't be read.
+*/
+
+{
+  FILE* file   = fopen(path, "r");
+  int   number = fallback;
+
+  if (file != NULL)
+  {
+    if (fscanf(file, "%d", &number) != 1)
+      number = fallback;
+
+    fclose(file);
+  }
+
+  return number;
+}
+
+/*********************************************************************************************/
+
+static int pinToMask
+(
+  const unsigned long* mask                                                  // the CPUs to use
+)
+
+/*
+This function restricts the calling thread to a set of CPUs.
+
+PRECONDITIONS:
+"mask" must have "AFFINITY_MAX_CPUS" bits.
+
+POSTCONDITIONS:
+Non-zero is returned if the thread is now restricted to the CPUs in "mask", or 0 if it
+couldn't be.
+*/
+
+{
+  cpu_set_t set;
+  int       cpu;
+
+  CPU_ZERO(&set);
+
+  for (cpu = 0; (cpu < AFFINITY_MAX_CPUS) && (cpu < CPU_SETSIZE); cpu++)
+  {
+    if (AFFINITY_ISSET(cpu, mask))
+      CPU_SET(cpu, &set);
+  }
+
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+#endif
@@ -0,0 +1,384 @@
+// ============================================================================================
+//
+// alloc.cpp -- Aligned and Large-Page Memory Allocation
+//
+// ============================================================================================
+
+/*
+This source file defines the aligned and large-page memory allocation routines.  See "alloc.h"
+for details.
+*/
+
+// ============================================================================================
+// DESIGN NOTES
+// ============================================================================================
+
+/*
+Aligned blocks come from "_aligned_malloc()" with Microsoft's C library (and MinGW's, which is
+Microsoft's), from "posix_memalign()" on POSIX systems and, everywhere else, from "malloc()":
+enough extra memory is allocated to find an aligned address within it, and the address that
+"malloc()" returned is stored just before the aligned address so that it can be freed later.
+
+Large blocks are mapped directly from the operating system ("mmap()" or "VirtualAlloc()")
+rather than allocated from the heap, so that they can be given huge pages and so that freeing
+them returns the memory to the operating system immediately.  For transparent huge pages the
+block must start on a huge page boundary, which "mmap()" doesn't guarantee, so a block one huge
+page larger than needed is mapped and the excess at either end is unmapped.  Where pages can't
+be mapped, large blocks are simply page-aligned blocks from the heap.
+
+Each platform always uses the same method, so the freeing routines never need to be told which
+method was used.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+#include "platform/alloc.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+  #define ALLOC_POSIX
+  #include <sys/types.h>
+  #include <sys/mman.h>
+#elif defined(_WIN32)
+  #define ALLOC_WIN32
+  #include <windows.h>
+#endif
+
+#if defined(ALLOC_WIN32) && ((PF_COMPILER == PF_MICROSOFT) || defined(__MINGW32__))
+  #define ALIGNED_MSVCRT
+  #include <malloc.h>
+#elif defined(ALLOC_POSIX)
+  #define ALIGNED_POSIX
+#else
+  #define ALIGNED_PORTABLE
+#endif
+
+#if defined(ALLOC_POSIX) && !defined(MAP_ANONYMOUS)
+  #define MAP_ANONYMOUS MAP_ANON                  // the older BSD name (still used by Mac OS)
+#endif
+
+// ============================================================================================
+// PRIVATE FUNCTION DECLARATIONS
+// ============================================================================================
+
+static size_t roundUp(const size_t, const size_t);
+
+#if defined(ALLOC_POSIX)
+  static void* mapPages(const size_t, int*);
+#endif
+
+// ============================================================================================
+// FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+void* pf_aligned_alloc
+(
+  const size_t size,                                          // the block's size, in bytes
+  const size_t alignment                        // the block's alignment (a power of 2, bytes)
+)
+
+/*
+This function allocates a block of memory from the heap whose address is a multiple of
+"alignment".
+
+PRECONDITIONS:
+"alignment" must be a power of 2.
+
+POSTCONDITIONS:
+A pointer to the block is returned, or NULL if it couldn't be allocated (or "alignment" isn't a
+power of 2).  The block must be freed with "pf_aligned_free()".
+*/
+
+{
+  const size_t actual = (alignment < sizeof(void*)) ? sizeof(void*) : alignment;
+
+  if ((alignment & (alignment - 1)) != 0)
+    return NULL;
+
+  #if defined(ALIGNED_MSVCRT)
+
+    return _aligned_malloc((size > 0) ? size : 1, actual);
+
+  #elif defined(ALIGNED_POSIX)
+
+    void* block;
+
+    if (posix_memalign(&block, actual, (size > 0) ? size : 1) != 0)
+      return NULL;
+
+    return block;
+
+  #else
+
+    unsigned char* raw;
+    unsigned char* aligned;
+
+    if (size > (size_t)-1 - actual - sizeof(void*))                     // the total would wrap
+      return NULL;
+
+    raw = (unsigned char*)malloc(size + actual + sizeof(void*));
+
+    if (raw == NULL)
+      return NULL;
+
+    aligned  = raw + sizeof(void*);
+    aligned += (actual - ((size_t)aligned & (actual - 1))) & (actual - 1);
+    ((void**)aligned)[-1] = raw;
+    return aligned;
+
+  #endif
+}
+
+/*********************************************************************************************/
+
+void pf_aligned_free
+(
+  void* block                                                            // the block to free
+)
+
+/*
+This function frees a block of memory allocated by "pf_aligned_alloc()".
+
+PRECONDITIONS:
+"block" must be NULL or have been returned by "pf_aligned_alloc()" (and not freed since).
+
+POSTCONDITIONS:
+The block is freed.  Nothing is done if "block" is NULL.
+*/
+
+{
+  if (block == NULL)
+    return;
+
+  #if defined(ALIGNED_MSVCRT)
+    _aligned_free(block);
+  #elif defined(ALIGNED_POSIX)
+    free(block);
+  #else
+    free(((void**)block)[-1]);
+  #endif
+}
+
+/*********************************************************************************************/
+
+void* pf_large_alloc
+(
+  const size_t size,                                          // the block's size, in bytes
+  int*         tier                     // receives a "PF_LARGE_PAGES_..." value (may be NULL)
+)
+
+/*
+This function allocates a large block of memory, backed by huge pages if possible.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+A pointer to the block is returned and "*tier" is set to the kind of pages that back it, or
+NULL is returned and "*tier" is set to "PF_LARGE_PAGES_NONE" if the block couldn't be
+allocated.  The block must be freed with "pf_large_free()".
+*/
+
+{
+  const size_t rounded = roundUp(size, PF_LARGE_PAGE_SIZE);
+  int          got     = PF_LARGE_PAGES_NONE;
+  void*        block   = NULL;
+
+  if ((size > 0) && (rounded >= size))
+  {
+    #if defined(ALLOC_POSIX)
+
+      block = mapPages(rounded, &got);
+
+    #elif defined(ALLOC_WIN32)
+
+      // Large pages must be requested in multiples of their own size, which is only known at
+      // run time (and is 0 if they aren't supported).  They can't be committed on demand, so
+      // the whole block is committed up front either way.
+
+      const SIZE_T largePageSize = GetLargePageMinimum();
+
+      if ((largePageSize > 0) && (roundUp(rounded, largePageSize) == rounded))
+      {
+        block = VirtualAlloc(NULL, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                             PAGE_READWRITE);
+        got   = PF_LARGE_PAGES_HUGE;
+      }
+
+      if (block == NULL)
+      {
+        block = VirtualAlloc(NULL, rounded, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        got   = PF_LARGE_PAGES_NORMAL;
+      }
+
+    #else
+
+      block = pf_aligned_alloc(rounded, PF_PAGE_SIZE);
+      got   = PF_LARGE_PAGES_HEAP;
+
+    #endif
+  }
+
+  if (block == NULL)
+    got = PF_LARGE_PAGES_NONE;
+
+  if (tier != NULL)
+    *tier = got;
+
+  return block;
+}
+
+/*********************************************************************************************/
+
+void pf_large_free
+(
+  void*        block,                                                    // the block to free
+  const size_t size                      // the size that was passed to "pf_large_alloc()"
+)
+
+/*
+This function frees a block of memory allocated by "pf_large_alloc()".
+
+PRECONDITIONS:
+"block" must be NULL or have been returned by "pf_large_alloc()" (and not freed since), and
+"size" must be the size that was asked for.
+
+POSTCONDITIONS:
+The block is freed.  Nothing is done if "block" is NULL.
+*/
+
+{
+  if (block == NULL)
+    return;
+
+  #if defined(ALLOC_POSIX)
+    munmap(block, roundUp(size, PF_LARGE_PAGE_SIZE));
+  #elif defined(ALLOC_WIN32)
+    (void)size;
+    VirtualFree(block, 0, MEM_RELEASE);
+  #else
+    (void)size;
+    pf_aligned_free(block);
+  #endif
+}
+
+// ============================================================================================
+// PRIVATE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+static size_t roundUp
+(
+  const size_t size,                                                   // the size to round
+  const size_t multiple                                      // the multiple to round it up to
+)
+
+/*
+This function rounds a size up to a multiple of another size.
+
+PRECONDITIONS:
+"multiple" must be greater than 0.
+
+POSTCONDITIONS:
+The rounded size is returned.  If it can't be represented then a value less than "size" is
+returned.
+*/
+
+{
+  return ((size + multiple - 1) / multiple) * multiple;
+}
+
+/*********************************************************************************************/
+
+#if defined(ALLOC_POSIX)
+
+static void* mapPages
+(
+  const size_t size,                          // the size to map (a multiple of a huge page)
+  int*         tier                                // receives a "PF_LARGE_PAGES_..." value
+)
+
+/*
+This function maps anonymous pages, trying each tier in turn.
+
+PRECONDITIONS:
+"tier" must not be NULL.
+
+POSTCONDITIONS:
+The address of the pages is returned and "*tier" is set, or NULL is returned if no pages could
+be mapped.
+*/
+
+{
+  const int protection = PROT_READ | PROT_WRITE;
+  const int flags      = MAP_PRIVATE | MAP_ANONYMOUS;
+  void*     block;
+
+  #if defined(MAP_HUGETLB)
+
+    // "size" is only rounded up to "PF_LARGE_PAGE_SIZE", and the system's default huge page
+    // size may be larger (1 GiB, or 512 MiB on AArch64 with 64 KiB pages), in which case the
+    // block couldn't be unmapped again.  Where it can be chosen, the huge page size is
+    // therefore asked for explicitly (and the mapping fails if there are none of that size).
+
+    int hugeFlags = flags | MAP_HUGETLB;
+
+    #if defined(MAP_HUGE_SHIFT)
+      int sizeLog2 = 0;
+
+      while (((size_t)1 << sizeLog2) < PF_LARGE_PAGE_SIZE)
+        sizeLog2++;
+
+      hugeFlags |= sizeLog2 << MAP_HUGE_SHIFT;
+    #endif
+
+    block = mmap(NULL, size, protection, hugeFlags, -1, 0);
+
+    if (block != MAP_FAILED)
+    {
+      *tier = PF_LARGE_PAGES_HUGE;
+      return block;
+    }
+
+  #endif
+
+  #if defined(MADV_HUGEPAGE)
+
+    block = mmap(NULL, size + PF_LARGE_PAGE_SIZE, protection, flags, -1, 0);
+
+    if (block != MAP_FAILED)
+    {
+      char* const  start   = (char*)block;
+      const size_t leading = (PF_LARGE_PAGE_SIZE - ((size_t)start % PF_LARGE_PAGE_SIZE)) %
+                             PF_LARGE_PAGE_SIZE;
+
+      if (leading > 0)
+        munmap(start, leading);
+
+      munmap(start + leading + size, PF_LARGE_PAGE_SIZE - leading);
+      block = start + leading;
+      *tier = (madvise(block, size, MADV_HUGEPAGE) == 0) ? PF_LARGE_PAGES_TRANSPARENT :
+                                                           PF_LARGE_PAGES_NORMAL;
+      return block;
+    }
+
+  #endif
+
+  block = mmap(NULL, size, protection, flags, -1, 0);
+
+  if (block == MAP_FAILED)
+    return NULL;
+
+  *tier = PF_LARGE_PAGES_NORMAL;
+  return block;
+}
+
+#endif
@@ -0,0 +1,223 @@
+// ============================================================================================
+//
+// arena.cpp -- Arena (Bump) Allocation
+//
+// ============================================================================================
+
+/*
+This source file defines the out-of-line members of "pf::arena".  See "arena.h" for details.
+*/
+
+// ============================================================================================
+// DESIGN NOTES
+// ============================================================================================
+
+/*
+The chunks form a singly-linked list in the order in which they're used.  Each chunk begins
+with a header that's padded to a whole cache line, so the first block in a chunk (and every
+block aligned to a cache line after it) is aligned to a cache line.
+
+"reset()" rewinds to the first chunk.  When a chunk fills up, the following chunk in the list
+is used if it's large enough for the block; chunks that aren't are skipped (until the next
+reset) and a new chunk is only allocated, and linked in after the current one, when the end of
+the list is reached.  A block larger than a chunk gets a chunk of its own.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include "platform.h"
+#include "platform/arena.h"
+
+// ============================================================================================
+// PRIVATE MACRO DEFINITIONS
+// ============================================================================================
+
+// The size of a chunk's header, padded to a whole cache line
+
+#define ARENA_HEADER_SIZE                                                                     \
+  (((sizeof(chunk) + PF_CACHE_LINE_SIZE - 1) / PF_CACHE_LINE_SIZE) * PF_CACHE_LINE_SIZE)
+
+namespace pf
+{
+
+// ============================================================================================
+// FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+arena::arena
+(
+  const size_t chunkSize                                           // the usual size of a chunk
+):
+  _first(NULL),
+  _current(NULL),
+  _next(NULL),
+  _end(NULL),
+  _chunkSize(chunkSize),
+  _reserved(0)
+
+/*
+This constructor creates an empty arena.  No memory is allocated until the first block is.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The arena is empty.
+*/
+
+{
+}
+
+/*********************************************************************************************/
+
+arena::~arena()
+
+/*
+This destructor frees all of the arena's chunks.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+Every block allocated from the arena is invalid.
+*/
+
+{
+  release();
+}
+
+/*********************************************************************************************/
+
+void arena::reset()
+
+/*
+This function frees every block allocated from the arena but keeps the chunks for reuse.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+Every block allocated from the arena is invalid.
+*/
+
+{
+  _current = _first;
+
+  if (_current != NULL)
+  {
+    _next = (char*)_current + ARENA_HEADER_SIZE;
+    _end  = (char*)_current + _current->size;
+  }
+}
+
+/*********************************************************************************************/
+
+void arena::release()
+
+/*
+This function frees every block allocated from the arena and returns the chunks to the
+operating system (or heap).
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+Every block allocated from the arena is invalid and the arena is empty.
+*/
+
+{
+  while (_first != NULL)
+  {
+    chunk* const unused = _first;
+
+    _first = unused->next;
+
+    if (unused->size >= PF_LARGE_PAGE_SIZE)
+      pf_large_free(unused, unused->size);
+    else
+      pf_aligned_free(unused);
+  }
+
+  _current  = NULL;
+  _next     = NULL;
+  _end      = NULL;
+  _reserved = 0;
+}
+
+/*********************************************************************************************/
+
+void* arena::grow
+(
+  const size_t size,                                              // the block's size, in bytes
+  const size_t alignment                         // the block's alignment (a power of 2, bytes)
+)
+
+/*
+This function allocates a block of memory from the next chunk that's large enough for it,
+allocating a new chunk if there isn't one.
+
+PRECONDITIONS:
+The block doesn't fit in the current chunk (if any) and "alignment" is no greater than
+"PF_CACHE_LINE_SIZE".
+
+POSTCONDITIONS:
+A pointer to the block is returned, or NULL if a new chunk was needed and couldn't be
+allocated.
+*/
+
+{
+  const size_t needed    = ARENA_HEADER_SIZE + size;
+  chunk*       candidate = (_current != NULL) ? _current->next : _first;
+
+  (void)alignment;                                        // every chunk starts on a cache line
+
+  if (needed < size)
+    return NULL;
+
+  while ((candidate != NULL) && (candidate->size < needed))
+    candidate = candidate->next;
+
+  if (candidate == NULL)
+  {
+    size_t chunkSize = (needed > _chunkSize) ? needed : _chunkSize;
+
+    if (chunkSize >= PF_LARGE_PAGE_SIZE)
+    {
+      chunkSize = ((chunkSize + PF_LARGE_PAGE_SIZE - 1) / PF_LARGE_PAGE_SIZE) *
+                  PF_LARGE_PAGE_SIZE;
+      candidate = (chunk*)pf_large_alloc(chunkSize, NULL);
+    }
+    else
+    {
+      candidate = (chunk*)pf_aligned_alloc(chunkSize, PF_CACHE_LINE_SIZE);
+    }
+
+    if (candidate == NULL)
+      return NULL;
+
+    candidate->size = chunkSize;
+    _reserved      += chunkSize;
+
+    if (_current != NULL)
+    {
+      candidate->next = _current->next;
+      _current->next  = candidate;
+    }
+    else
+    {
+      candidate->next = _first;
+      _first          = candidate;
+    }
+  }
+
+  _current = candidate;
+  _next    = (char*)candidate + needed;
+  _end     = (char*)candidate + candidate->size;
+  return (char*)candidate + ARENA_HEADER_SIZE;
+}
+
+}
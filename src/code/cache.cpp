@@ -0,0 +1,528 @@
+// ============================================================================================
+//
+// cache.cpp -- Run-Time Cache Topology Query
+//
+// ============================================================================================
+
+/*
+This source file defines the routines that query the CPU's cache topology and the operating
+system's page size.  See "cache.h" for details.
+*/
+
+// ============================================================================================
+// DESIGN NOTES
+// ============================================================================================
+
+/*
+Each platform is asked in the most reliable way available to it:
+
+  Linux        The kernel describes every cache of every CPU under
+               "/sys/devices/system/cpu/cpuN/cache/indexM/" (on every CPU family, including
+               ARM CPU's, whose caches can't be described from user mode).
+  Mac OS       "sysctlbyname()" ("hw.l1dcachesize", etc.).
+  Windows      "GetLogicalProcessorInformation()".
+  x86 CPU's    CPUID leaf 4 (Intel) or leaf 0x8000001D (AMD), if none of the above are
+               available or they don't know.
+
+As in "cpufeat.cpp", the caches are described during static initialization, and again by
+"pf_cache_info()" if it's called before that happens.  The description is always the same, so
+it doesn't matter if two threads happen to build it at the same time.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+#include "platform/cache.h"
+#include "platform/cpufeat.h"
+
+#if defined(__APPLE__)
+  #include <sys/types.h>
+  #include <sys/sysctl.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <unistd.h>
+#elif defined(_WIN32)
+  #include <windows.h>
+#endif
+
+// ============================================================================================
+// PRIVATE MACRO DEFINITIONS
+// ============================================================================================
+
+// Cache types, as numbered by CPUID leaf 4
+
+#define CACHE_TYPE_DATA        1
+#define CACHE_TYPE_INSTRUCTION 2
+#define CACHE_TYPE_UNIFIED     3
+
+// ============================================================================================
+// PRIVATE FUNCTION DECLARATIONS
+// ============================================================================================
+
+static int         recordCache(PfCacheInfo*, const int, const int, const PfCacheLevel&);
+static int         describeFromSysfs(PfCacheInfo*);
+static int         describeFromCpuid(PfCacheInfo*);
+static int         describeFromSysctl(PfCacheInfo*);
+static int         describeFromWindows(PfCacheInfo*);
+static PfCacheInfo describeCaches(void);
+
+// ============================================================================================
+// STATIC VARIABLE DEFINITIONS
+// ============================================================================================
+
+static int         cachesDescribed = 0;                   // non-zero once "caches" is valid
+static PfCacheInfo caches          = describeCaches();              // the cached description
+
+// ============================================================================================
+// FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+const PfCacheInfo* pf_cache_info(void)
+
+/*
+This function describes the caches of the CPU that the program is running on.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+A pointer to the description is returned.  It remains valid for the life of the program.  Any
+property that couldn't be determined is 0 (every property is 0 for a cache that doesn't exist
+or couldn't be found).
+*/
+
+{
+  if (!cachesDescribed)
+    caches = describeCaches();
+
+  return &caches;
+}
+
+/*********************************************************************************************/
+
+unsigned long pf_page_size(void)
+
+/*
+This function determines the size of the operating system's memory pages.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The page size, in bytes, is returned.  If it can't be determined then "PF_PAGE_SIZE" is
+returned.
+*/
+
+{
+  #if defined(__unix__) || defined(__APPLE__)
+
+    const long size = sysconf(_SC_PAGESIZE);
+
+    return (size > 0) ? (unsigned long)size : PF_PAGE_SIZE;
+
+  #elif defined(_WIN32)
+
+    SYSTEM_INFO system;
+
+    GetSystemInfo(&system);
+    return system.dwPageSize;
+
+  #else
+
+    return PF_PAGE_SIZE;
+
+  #endif
+}
+
+// ============================================================================================
+// PRIVATE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+static int recordCache
+(
+  PfCacheInfo*        found,                                    // the description to update
+  const int           level,                                // the cache's level (1, 2 or 3)
+  const int           type,                                // a "CACHE_TYPE_..." value
+  const PfCacheLevel& cache                                                   // the cache
+)
+
+/*
+This function adds one cache to a description of the caches.  If the description already has a
+cache in that position then it's kept (the first one found is taken to be the one that's
+closest to the first CPU).
+
+PRECONDITIONS:
+"found" must not be NULL.
+
+POSTCONDITIONS:
+Non-zero is returned if the cache was recorded; otherwise, 0 is returned.
+*/
+
+{
+  PfCacheLevel* target = NULL;
+
+  if ((level == 1) && (type == CACHE_TYPE_INSTRUCTION))
+    target = &found->level1Instruction;
+  else if (type == CACHE_TYPE_INSTRUCTION)
+    target = NULL;
+  else if (level == 1)
+    target = &found->level1Data;
+  else if (level == 2)
+    target = &found->level2;
+  else if (level == 3)
+    target = &found->level3;
+
+  if ((target == NULL) || (target->size != 0) || (cache.size == 0))
+    return 0;
+
+  *target = cache;
+  return 1;
+}
+
+/*********************************************************************************************/
+
+static int describeFromSysfs
+(
+  PfCacheInfo* found                                             // receives the description
+)
+
+/*
+This function reads the description of the first CPU's caches that the Linux kernel publishes.
+
+PRECONDITIONS:
+"found" must not be NULL.
+
+POSTCONDITIONS:
+The number of caches recorded in "found" is returned (0 if the description can't be read).
+*/
+
+{
+  int recorded = 0;
+
+  #if defined(__linux__)
+
+    static const char* const names[] =
+      {"level", "type", "size", "coherency_line_size", "ways_of_associativity",
+       "shared_cpu_list"};
+
+    int index;
+
+    for (index = 0; index < 16; index++)
+    {
+      char         values[6][256];
+      int          valuesRead = 0;
+      int          name;
+      PfCacheLevel cache;
+      char*        suffix;
+      const char*  list;
+      int          type;
+
+      for (name = 0; name < 6; name++)
+      {
+        char  path[128];
+        FILE* file;
+
+        sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/%s", index, names[name]);
+        values[name][0] = '\0';
+
+        if ((file = fopen(path, "r")) != NULL)
+        {
+          if (fgets(values[name], sizeof(values[name]), file) != NULL)
+            valuesRead++;
+
+          fclose(file);
+        }
+      }
+
+      if (valuesRead == 0)
+        break;
+
+      // The size is given in kibibytes ("32K") or mebibytes ("8M"); the list of CPU's sharing
+      // the cache is a comma-separated list of numbers and ranges ("0-3,8-11").
+
+      cache.size = strtoul(values[2], &suffix, 10);
+
+      if (*suffix == 'K')
+        cache.size *= 1024UL;
+      else if (*suffix == 'M')
+        cache.size *= 1024UL * 1024UL;
+
+      cache.lineSize      = strtoul(values[3], NULL, 10);
+      cache.associativity = strtoul(values[4], NULL, 10);
+      cache.sharedBy      = 0;
+
+      for (list = values[5]; (*list >= '0') && (*list <= '9'); )
+      {
+        char*               end;
+        const unsigned long first = strtoul(list, &end, 10);
+        unsigned long       last  = first;
+
+        if (*end == '-')
+          last = strtoul(end + 1, &end, 10);
+
+        cache.sharedBy += last - first + 1;
+        list = (*end == ',') ? end + 1 : end;
+      }
+
+      if (strncmp(values[1], "Data", 4) == 0)
+        type = CACHE_TYPE_DATA;
+      else if (strncmp(values[1], "Instruction", 11) == 0)
+        type = CACHE_TYPE_INSTRUCTION;
+      else
+        type = CACHE_TYPE_UNIFIED;
+
+      recorded += recordCache(found, atoi(values[0]), type, cache);
+    }
+
+  #else
+
+    (void)found;
+
+  #endif
+
+  return recorded;
+}
+
+/*********************************************************************************************/
+
+static int describeFromCpuid
+(
+  PfCacheInfo* found                                             // receives the description
+)
+
+/*
+This function asks an x86 CPU to describe its caches.  Intel CPU's describe them with CPUID
+leaf 4 and AMD CPU's with leaf 0x8000001D, in the same format.
+
+PRECONDITIONS:
+"found" must not be NULL.
+
+POSTCONDITIONS:
+The number of caches recorded in "found" is returned (0 if the CPU isn't an x86 CPU or can't
+describe its caches).
+*/
+
+{
+  static const unsigned long leaves[] = {4, 0x8000001DUL};
+
+  int           recorded = 0;
+  unsigned long registers[4];
+  int           leaf;
+  unsigned long subleaf;
+
+  for (leaf = 0; (leaf < 2) && (recorded == 0); leaf++)
+  {
+    for (subleaf = 0; pf_cpuid(leaves[leaf], subleaf, registers); subleaf++)
+    {
+      const int     type = (int)(registers[0] & 0x1fUL);
+      unsigned long ways;
+      unsigned long partitions;
+      PfCacheLevel  cache;
+
+      if ((type == 0) || (subleaf >= 16))
+        break;
+
+      // EBX holds the ways, partitions and line size, and ECX the sets, each less 1.
+
+      ways       = ((registers[1] >> 22) & 0x3ffUL) + 1;
+      partitions = ((registers[1] >> 12) & 0x3ffUL) + 1;
+
+      cache.lineSize      = (registers[1] & 0xfffUL) + 1;
+      cache.size          = ways * partitions * cache.lineSize * (registers[2] + 1);
+      cache.associativity = (registers[0] & (1UL << 9)) ? 0 : ways;
+      cache.sharedBy      = ((registers[0] >> 14) & 0xfffUL) + 1;
+
+      recorded += recordCache(found, (int)((registers[0] >> 5) & 0x07UL), type, cache);
+    }
+  }
+
+  return recorded;
+}
+
+/*********************************************************************************************/
+
+static int describeFromSysctl
+(
+  PfCacheInfo* found                                             // receives the description
+)
+
+/*
+This function asks the Mac OS kernel to describe the caches.  "hw.cacheconfig" holds the
+number of logical CPU's that share memory, then each level of cache, in that order.
+
+PRECONDITIONS:
+"found" must not be NULL.
+
+POSTCONDITIONS:
+The number of caches recorded in "found" is returned (0 if the description can't be read).
+*/
+
+{
+  int recorded = 0;
+
+  #if defined(__APPLE__)
+
+    static const char* const names[] =
+      {"hw.l1dcachesize", "hw.l1icachesize", "hw.l2cachesize", "hw.l3cachesize"};
+    static const int levels[] = {1, 1, 2, 3};
+    static const int types[]  = {CACHE_TYPE_DATA, CACHE_TYPE_INSTRUCTION, CACHE_TYPE_UNIFIED,
+                                 CACHE_TYPE_UNIFIED};
+
+    long long lineSize       = 0;
+    long long sharing[4]     = {0, 0, 0, 0};
+    size_t    lineSizeLength = sizeof(lineSize);
+    size_t    sharingLength  = sizeof(sharing);
+    int       name;
+
+    if (sysctlbyname("hw.cachelinesize", &lineSize, &lineSizeLength, NULL, 0) != 0)
+      lineSize = 0;
+
+    if (sysctlbyname("hw.cacheconfig", sharing, &sharingLength, NULL, 0) != 0)
+      memset(sharing, 0, sizeof(sharing));
+
+    for (name = 0; name < 4; name++)
+    {
+      long long    size       = 0;
+      size_t       sizeLength = sizeof(size);
+      PfCacheLevel cache;
+
+      if (sysctlbyname(names[name], &size, &sizeLength, NULL, 0) != 0)
+        continue;
+
+      cache.size          = (unsigned long)size;
+      cache.lineSize      = (unsigned long)lineSize;
+      cache.associativity = 0;
+      cache.sharedBy      = (unsigned long)sharing[levels[name]];
+
+      recorded += recordCache(found, levels[name], types[name], cache);
+    }
+
+  #else
+
+    (void)found;
+
+  #endif
+
+  return recorded;
+}
+
+/*********************************************************************************************/
+
+static int describeFromWindows
+(
+  PfCacheInfo* found                                             // receives the description
+)
+
+/*
+This function asks Windows to describe the caches.  Windows lists every cache of every CPU,
+so the first of each kind is taken to be the first CPU's.
+
+PRECONDITIONS:
+"found" must not be NULL.
+
+POSTCONDITIONS:
+The number of caches recorded in "found" is returned (0 if the description can't be read).
+*/
+
+{
+  int recorded = 0;
+
+  #if defined(_WIN32)
+
+    DWORD                                 length = 0;
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION* buffer;
+    DWORD                                 i;
+
+    GetLogicalProcessorInformation(NULL, &length);
+
+    if ((length == 0) ||
+        ((buffer = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION*)malloc(length)) == NULL))
+      return 0;
+
+    if (GetLogicalProcessorInformation(buffer, &length))
+    {
+      const DWORD count = length / sizeof(*buffer);
+
+      for (i = 0; i < count; i++)
+      {
+        const CACHE_DESCRIPTOR* descriptor = &buffer[i].Cache;
+        PfCacheLevel            cache;
+        int                     type;
+        ULONG_PTR               mask;
+
+        if (buffer[i].Relationship != RelationCache)
+          continue;
+
+        if (descriptor->Type == CacheData)
+          type = CACHE_TYPE_DATA;
+        else if (descriptor->Type == CacheInstruction)
+          type = CACHE_TYPE_INSTRUCTION;
+        else if (descriptor->Type == CacheUnified)
+          type = CACHE_TYPE_UNIFIED;
+        else
+          continue;
+
+        cache.size          = descriptor->Size;
+        cache.lineSize      = descriptor->LineSize;
+        cache.associativity = descriptor->Associativity;
+        cache.sharedBy      = 0;
+
+        if (cache.associativity == 0xff)                                 // fully associative
+          cache.associativity = 0;
+
+        for (mask = buffer[i].ProcessorMask; mask != 0; mask &= mask - 1)
+          cache.sharedBy++;
+
+        recorded += recordCache(found, descriptor->Level, type, cache);
+      }
+    }
+
+    free(buffer);
+
+  #else
+
+    (void)found;
+
+  #endif
+
+  return recorded;
+}
+
+/*********************************************************************************************/
+
+static PfCacheInfo describeCaches(void)
+
+/*
+This function describes the caches of the CPU that the program is running on, asking each
+source in turn until one of them knows.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The description is returned and "cachesDescribed" is set.
+*/
+
+{
+  PfCacheInfo found;
+
+  memset(&found, 0, sizeof(found));
+
+  if ((describeFromSysfs(&found) == 0) && (describeFromSysctl(&found) == 0) &&
+      (describeFromWindows(&found) == 0))
+    describeFromCpuid(&found);
+
+  cachesDescribed = 1;
+  return found;
+}
@@ -0,0 +1,221 @@
+// ============================================================================================
+//
+// counter.cpp -- Sharded Statistics Counters
+//
+// ============================================================================================
+
+/*
+This source file defines the parts of "pf::sharded_counter" that aren't inline.  See
+"counter.h" for details.
+*/
+
+// ============================================================================================
+// DESIGN NOTES
+// ============================================================================================
+
+/*
+Adding is a relaxed atomic addition to the thread's shard rather than a plain one, since a
+shard can be shared by more than one thread; when it isn't, the addition finds the shard's
+cache line already in the CPU's cache and costs about as much as an ordinary memory write.
+
+A thread's shard number is kept in an initial-exec thread-local variable (see
+"PF_TLS_INITIAL_EXEC"), so finding it takes one load even when the counter is used from a
+shared library.  The number stored is 1 more than the order in which the thread was assigned
+one, so that 0 (the initial value of every thread's copy) means "not assigned yet"; it's
+masked with the counter's "_mask", so one assignment serves every counter.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <new>
+
+#include "platform.h"
+#include "platform/affinity.h"
+#include "platform/alloc.h"
+#include "platform/counter.h"
+
+// ============================================================================================
+// PRIVATE MACRO DEFINITIONS
+// ============================================================================================
+
+// The largest number of shards that a counter can have
+
+#define COUNTER_MAX_SHARDS 4096
+
+namespace pf
+{
+
+// ============================================================================================
+// STATIC VARIABLE DEFINITIONS
+// ============================================================================================
+
+#ifdef PF_THREAD_LOCAL
+  PF_THREAD_LOCAL PF_TLS_INITIAL_EXEC unsigned sharded_counter::_threadShard = 0;
+  pf_atomic32_t                                sharded_counter::_nextShard;
+#endif
+
+// ============================================================================================
+// FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+sharded_counter::sharded_counter
+(
+  const unsigned shards                               // the number of shards (0 = one per CPU)
+):
+  _shards(&_single),
+  _mask(0)
+
+/*
+This constructor creates a counter with a total of 0.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The counter is ready to use.  If its shards can't be allocated then "shards()" is 1.
+*/
+
+{
+  const unsigned wanted = (shards > 0) ? shards : (unsigned)pf_cpu_count();
+  unsigned       count  = 1;
+  unsigned       index;
+
+  pf_atomic_store64(&_single->count, 0, PF_MEMORY_ORDER_RELAXED);
+
+  while ((count < wanted) && (count < COUNTER_MAX_SHARDS))
+    count <<= 1;
+
+  if (count < 2)
+    return;
+
+  _shards = (padded<shard>*)pf_aligned_alloc(count * sizeof(padded<shard>),
+                                             PF_CACHE_LINE_SIZE);
+
+  if (_shards == NULL)
+  {
+    _shards = &_single;
+    return;
+  }
+
+  for (index = 0; index < count; index++)
+  {
+    new (&_shards[index]) padded<shard>();
+    pf_atomic_store64(&_shards[index]->count, 0, PF_MEMORY_ORDER_RELAXED);
+  }
+
+  _mask = count - 1;
+}
+
+/*********************************************************************************************/
+
+sharded_counter::~sharded_counter()
+
+/*
+This destructor frees the counter's shards.
+
+PRECONDITIONS:
+No other thread may be using the counter.
+
+POSTCONDITIONS:
+The counter's memory has been freed.
+*/
+
+{
+  unsigned index;
+
+  if (_shards == &_single)
+    return;
+
+  for (index = 0; index <= _mask; index++)
+    _shards[index].~padded<shard>();
+
+  pf_aligned_free(_shards);
+}
+
+/*********************************************************************************************/
+
+int64_t sharded_counter::value() const
+
+/*
+This function determines the counter's total.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The sum of the shards is returned.
+*/
+
+{
+  int64_t  total = 0;
+  unsigned index;
+
+  for (index = 0; index <= _mask; index++)
+    total += pf_atomic_load64(&_shards[index]->count, PF_MEMORY_ORDER_RELAXED);
+
+  return total;
+}
+
+/*********************************************************************************************/
+
+void sharded_counter::reset()
+
+/*
+This function sets the counter's total to 0.
+
+PRECONDITIONS:
+No other thread may be adding to the counter.
+
+POSTCONDITIONS:
+Every shard is 0.
+*/
+
+{
+  unsigned index;
+
+  for (index = 0; index <= _mask; index++)
+    pf_atomic_store64(&_shards[index]->count, 0, PF_MEMORY_ORDER_RELAXED);
+}
+
+// ============================================================================================
+// PRIVATE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+unsigned sharded_counter::assignShard()
+
+/*
+This function assigns the calling thread a shard number the first time that it uses a counter.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The calling thread's shard number (never 0) is returned.
+*/
+
+{
+  #ifdef PF_THREAD_LOCAL
+
+    unsigned assigned = (unsigned)pf_atomic_fetch_add32(&_nextShard, 1,
+                                                        PF_MEMORY_ORDER_RELAXED) + 1;
+
+    if (assigned == 0)                                            // after 2^32 threads, skip 0
+      assigned = 1;
+
+    _threadShard = assigned;
+    return assigned;
+
+  #else
+
+    return threadShard();
+
+  #endif
+}
+
+}
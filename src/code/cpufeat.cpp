@@ -0,0 +1,395 @@
+// ============================================================================================
+//
+// cpufeat.cpp -- Run-Time CPU Feature Detection
+//
+// ============================================================================================
+
+/*
+This source file defines the routines that query the CPU for its instruction set extensions
+and cache the result.  See "cpufeat.h" for details.
+*/
+
+// ============================================================================================
+// DESIGN NOTES
+// ============================================================================================
+
+/*
+x86 CPU's are queried with the CPUID instruction.  A CPU may support AVX or AVX-512 and yet
+the operating system may not save the wider registers on a context switch, so the XGETBV
+instruction is also used to confirm that the operating system has enabled them.
+
+ARM CPU's can't be queried directly from user mode, so the operating system is asked instead:
+"getauxval()" on Linux, "sysctlbyname()" on Mac OS and "IsProcessorFeaturePresent()" on
+Windows.  NEON (Advanced SIMD) is mandatory on AArch64, so it's always reported there.
+
+The features are detected during static initialization.  Static initialization order across
+translation units is undefined, though, so "pf_cpu_features()" also detects them itself if it's
+called before that happens.  Detection always produces the same result, so it doesn't matter if
+two threads happen to do it at the same time.
+
+"pf_cpu_features()" is called by the indirect function resolvers that "PF_DISPATCH()"
+generates, which the dynamic loader can run before this file's own relocations have been
+processed, so detection must only use instructions and system queries that are safe then
+(CPUID, XGETBV, "getauxval()") -- never the heap, standard I/O, "errno" or thread-local
+variables.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include "platform.h"
+#include "platform/cpufeat.h"
+
+#if ((PF_CPU == PF_INTEL_X86) || (PF_CPU == PF_AMD_X86_64))
+  #define CPUFEAT_X86
+#elif (PF_CPU == PF_ARM_AARCH64)
+  #define CPUFEAT_AARCH64
+#elif (PF_CPU == PF_ARM_AARCH32)
+  #define CPUFEAT_ARM
+#endif
+
+#if defined(CPUFEAT_X86) && (PF_COMPILER == PF_GNU)
+  #include <cpuid.h>
+#elif defined(CPUFEAT_X86) && (PF_COMPILER == PF_MICROSOFT)
+  #include <intrin.h>
+#endif
+
+#if (defined(CPUFEAT_AARCH64) || defined(CPUFEAT_ARM)) && defined(__linux__)
+  #include <sys/auxv.h>
+#elif (defined(CPUFEAT_AARCH64) || defined(CPUFEAT_ARM)) && defined(__APPLE__)
+  #include <sys/types.h>
+  #include <sys/sysctl.h>
+#elif (defined(CPUFEAT_AARCH64) || defined(CPUFEAT_ARM)) && defined(_WIN32)
+  #include <windows.h>
+#endif
+
+// ============================================================================================
+// PRIVATE FUNCTION DECLARATIONS
+// ============================================================================================
+
+static unsigned long detectCpuFeatures(void);
+
+// ============================================================================================
+// STATIC VARIABLE DEFINITIONS
+// ============================================================================================
+
+static int           featuresDetected = 0;             // non-zero once "features" is valid
+static unsigned long features         = detectCpuFeatures();   // the cached feature bitmask
+
+// ============================================================================================
+// FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+unsigned long pf_cpu_features(void)
+
+/*
+This function returns the instruction set extensions supported by the CPU that the program is
+running on as a bitmask of "PF_CPU_FEATURE_..." values.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The CPU's features are returned.  Bits for features that can't be detected on this platform
+are always clear.
+*/
+
+{
+  if (!featuresDetected)
+    features = detectCpuFeatures();
+
+  return features;
+}
+
+/*********************************************************************************************/
+
+int pf_cpu_has
+(
+  const unsigned long wanted                     // the "PF_CPU_FEATURE_..." bits to check for
+)
+
+/*
+This function checks whether or not the CPU that the program is running on supports all of
+the instruction set extensions in "wanted".
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+Non-zero is returned if every feature in "wanted" is supported; otherwise, 0 is returned.
+*/
+
+{
+  return (pf_cpu_features() & wanted) == wanted;
+}
+
+/*********************************************************************************************/
+
+int pf_cpuid
+(
+  const unsigned long leaf,                                  // the CPUID leaf (EAX) to query
+  const unsigned long subleaf,                            // the CPUID sub-leaf (ECX) to query
+  unsigned long       registers[4]                   // receives EAX, EBX, ECX & EDX, in order
+)
+
+/*
+This function executes the x86 CPUID instruction.  It's exposed so that other modules can read
+leaves that aren't summarized in the feature bitmask (cache topology, for example).
+
+PRECONDITIONS:
+"registers" must not be NULL.
+
+POSTCONDITIONS:
+If the CPU is an x86 CPU that supports CPUID and "leaf" is within its range of supported
+leaves (basic or extended, as appropriate), "registers" holds the result and non-zero is
+returned.  Otherwise, "registers" is zero-filled and 0 is returned.
+*/
+
+{
+  registers[0] = registers[1] = registers[2] = registers[3] = 0;
+
+  #if defined(CPUFEAT_X86) && (PF_COMPILER == PF_GNU)
+
+    const unsigned int highest = __get_cpuid_max((unsigned int)(leaf & 0x80000000UL), 0);
+    unsigned int       eax, ebx, ecx, edx;
+
+    if ((highest == 0) || (highest < leaf))
+      return 0;
+
+    __cpuid_count((unsigned int)leaf, (unsigned int)subleaf, eax, ebx, ecx, edx);
+    registers[0] = eax;
+    registers[1] = ebx;
+    registers[2] = ecx;
+    registers[3] = edx;
+    return 1;
+
+  #elif defined(CPUFEAT_X86) && (PF_COMPILER == PF_MICROSOFT) && (PF_COMPILER_VER >= 1500)
+
+    int result[4];
+
+    __cpuid(result, (int)(leaf & 0x80000000UL));
+
+    if ((unsigned long)result[0] < leaf)
+      return 0;
+
+    __cpuidex(result, (int)leaf, (int)subleaf);
+    registers[0] = (unsigned long)result[0];
+    registers[1] = (unsigned long)result[1];
+    registers[2] = (unsigned long)result[2];
+    registers[3] = (unsigned long)result[3];
+    return 1;
+
+  #else
+
+    (void)leaf;
+    (void)subleaf;
+    return 0;
+
+  #endif
+}
+
+// ============================================================================================
+// PRIVATE FUNCTION DEFINITIONS
+// ============================================================================================
+
+#if defined(CPUFEAT_X86)
+
+/*********************************************************************************************/
+
+static unsigned long readXcr0(void)
+
+/*
+This function reads extended control register 0, which indicates which register sets the
+operating system saves on a context switch.
+
+PRECONDITIONS:
+The CPU and operating system must support XGETBV (CPUID leaf 1, ECX bit 27 -- OSXSAVE).
+
+POSTCONDITIONS:
+The low 32 bits of XCR0 are returned, or 0 if they can't be read with this compiler.
+*/
+
+{
+  #if (PF_COMPILER == PF_GNU)
+    unsigned int eax, edx;
+
+    __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    return eax;
+  #elif (PF_COMPILER == PF_MICROSOFT) && (PF_COMPILER_VER >= 1600)
+    return (unsigned long)(_xgetbv(0) & 0xffffffffUL);
+  #else
+    return 0;
+  #endif
+}
+
+#endif
+
+/*********************************************************************************************/
+
+#if (defined(CPUFEAT_AARCH64) || defined(CPUFEAT_ARM)) && defined(__APPLE__)
+
+static int sysctlFlag
+(
+  const char* name                                    // the name of a "hw.optional..." value
+)
+
+/*
+This function reads a Boolean hardware property from the Mac OS kernel.
+
+PRECONDITIONS:
+"name" must not be NULL.
+
+POSTCONDITIONS:
+Non-zero is returned if the property exists and is set; otherwise, 0 is returned.
+*/
+
+{
+  int    value = 0;
+  size_t size  = sizeof(value);
+
+  if (sysctlbyname(name, &value, &size, NULL, 0) != 0)
+    value = 0;
+
+  return value;
+}
+
+#endif
+
+/*********************************************************************************************/
+
+static unsigned long detectCpuFeatures(void)
+
+/*
+This function queries the CPU (or the operating system, where the CPU can't be queried
+directly) for the instruction set extensions that the program can use.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The feature bitmask is returned and "featuresDetected" is set.
+*/
+
+{
+  unsigned long found = 0;
+
+  #if defined(CPUFEAT_X86)
+
+    unsigned long registers[4];
+    unsigned long xcr0 = 0;
+
+    if (pf_cpuid(1, 0, registers))
+    {
+      const unsigned long ecx = registers[2];
+      const unsigned long edx = registers[3];
+
+      if (edx & (1UL << 25)) found |= PF_CPU_FEATURE_SSE;
+      if (edx & (1UL << 26)) found |= PF_CPU_FEATURE_SSE2;
+      if (ecx & (1UL <<  0)) found |= PF_CPU_FEATURE_SSE3;
+      if (ecx & (1UL <<  9)) found |= PF_CPU_FEATURE_SSSE3;
+      if (ecx & (1UL << 19)) found |= PF_CPU_FEATURE_SSE4_1;
+      if (ecx & (1UL << 20)) found |= PF_CPU_FEATURE_SSE4_2;
+      if (ecx & (1UL << 22)) found |= PF_CPU_FEATURE_MOVBE;
+      if (ecx & (1UL << 23)) found |= PF_CPU_FEATURE_POPCNT;
+
+      // AVX and its relatives are only usable if the OS saves the YMM registers.
+
+      if (ecx & (1UL << 27))
+        xcr0 = readXcr0();
+
+      if ((xcr0 & 0x06UL) == 0x06UL)
+      {
+        if (ecx & (1UL << 28)) found |= PF_CPU_FEATURE_AVX;
+        if (ecx & (1UL << 29)) found |= PF_CPU_FEATURE_F16C;
+        if (ecx & (1UL << 12)) found |= PF_CPU_FEATURE_FMA;
+      }
+    }
+
+    if (pf_cpuid(7, 0, registers))
+    {
+      const unsigned long ebx = registers[1];
+
+      if (ebx & (1UL << 3)) found |= PF_CPU_FEATURE_BMI1;
+      if (ebx & (1UL << 8)) found |= PF_CPU_FEATURE_BMI2;
+
+      if ((xcr0 & 0x06UL) == 0x06UL)
+      {
+        if (ebx & (1UL << 5)) found |= PF_CPU_FEATURE_AVX2;
+      }
+
+      // AVX-512 also needs the OS to save the opmask and upper ZMM registers.
+
+      if ((xcr0 & 0xe6UL) == 0xe6UL)
+      {
+        if (ebx & (1UL << 16)) found |= PF_CPU_FEATURE_AVX512F;
+        if (ebx & (1UL << 17)) found |= PF_CPU_FEATURE_AVX512DQ;
+        if (ebx & (1UL << 28)) found |= PF_CPU_FEATURE_AVX512CD;
+        if (ebx & (1UL << 30)) found |= PF_CPU_FEATURE_AVX512BW;
+        if (ebx & (1UL << 31)) found |= PF_CPU_FEATURE_AVX512VL;
+      }
+    }
+
+    if (pf_cpuid(0x80000001UL, 0, registers))
+    {
+      if (registers[2] & (1UL << 5)) found |= PF_CPU_FEATURE_LZCNT;
+    }
+
+  #elif defined(CPUFEAT_AARCH64) && defined(__linux__)
+
+    const unsigned long hwcap  = getauxval(AT_HWCAP);
+    const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+
+    found |= PF_CPU_FEATURE_NEON;
+
+    if (hwcap  & (1UL <<  3)) found |= PF_CPU_FEATURE_AES;          // HWCAP_AES
+    if (hwcap  & (1UL <<  6)) found |= PF_CPU_FEATURE_SHA2;         // HWCAP_SHA2
+    if (hwcap  & (1UL <<  7)) found |= PF_CPU_FEATURE_CRC32;        // HWCAP_CRC32
+    if (hwcap  & (1UL <<  8)) found |= PF_CPU_FEATURE_ATOMICS;      // HWCAP_ATOMICS
+    if (hwcap  & (1UL << 20)) found |= PF_CPU_FEATURE_DOTPROD;      // HWCAP_ASIMDDP
+    if (hwcap  & (1UL << 22)) found |= PF_CPU_FEATURE_SVE;          // HWCAP_SVE
+    if (hwcap2 & (1UL <<  1)) found |= PF_CPU_FEATURE_SVE2;         // HWCAP2_SVE2
+
+  #elif defined(CPUFEAT_ARM) && defined(__linux__)
+
+    const unsigned long hwcap  = getauxval(AT_HWCAP);
+    const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+
+    if (hwcap  & (1UL << 12)) found |= PF_CPU_FEATURE_NEON;         // HWCAP_NEON
+    if (hwcap2 & (1UL <<  0)) found |= PF_CPU_FEATURE_AES;          // HWCAP2_AES
+    if (hwcap2 & (1UL <<  3)) found |= PF_CPU_FEATURE_SHA2;         // HWCAP2_SHA2
+    if (hwcap2 & (1UL <<  4)) found |= PF_CPU_FEATURE_CRC32;        // HWCAP2_CRC32
+
+  #elif defined(CPUFEAT_AARCH64) && defined(__APPLE__)
+
+    found |= PF_CPU_FEATURE_NEON;
+
+    if (sysctlFlag("hw.optional.arm.FEAT_AES"))     found |= PF_CPU_FEATURE_AES;
+    if (sysctlFlag("hw.optional.arm.FEAT_SHA256"))  found |= PF_CPU_FEATURE_SHA2;
+    if (sysctlFlag("hw.optional.armv8_crc32"))      found |= PF_CPU_FEATURE_CRC32;
+    if (sysctlFlag("hw.optional.armv8_1_atomics"))  found |= PF_CPU_FEATURE_ATOMICS;
+    if (sysctlFlag("hw.optional.arm.FEAT_DotProd")) found |= PF_CPU_FEATURE_DOTPROD;
+
+  #elif defined(CPUFEAT_AARCH64) && defined(_WIN32)
+
+    found |= PF_CPU_FEATURE_NEON;
+
+    // The numbers are the Windows SDK's "PF_ARM_..." processor feature constants, which
+    // aren't defined by older SDK's.
+
+    if (IsProcessorFeaturePresent(30)) found |= PF_CPU_FEATURE_AES | PF_CPU_FEATURE_SHA2;
+    if (IsProcessorFeaturePresent(31)) found |= PF_CPU_FEATURE_CRC32;
+    if (IsProcessorFeaturePresent(34)) found |= PF_CPU_FEATURE_ATOMICS;
+    if (IsProcessorFeaturePresent(43)) found |= PF_CPU_FEATURE_DOTPROD;
+
+  #elif defined(CPUFEAT_AARCH64)
+
+    found |= PF_CPU_FEATURE_NEON;
+
+  #endif
+
+  featuresDetected = 1;
+  return found;
+}
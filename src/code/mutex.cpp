@@ -0,0 +1,219 @@
+// ============================================================================================
+//
+// mutex.cpp -- Adaptive Mutexes and Waiting on Addresses
+//
+// ============================================================================================
+
+/*
+This source file defines the routines that put threads to sleep on an address and wake them
+again, and the contended path of "pf::adaptive_mutex".  See "mutex.h" for details.
+*/
+
+// ============================================================================================
+// DESIGN NOTES
+// ============================================================================================
+
+/*
+The mutex is Ulrich Drepper's three-state futex mutex ("Futexes Are Tricky", mutex 2):  its
+state is 0 when it's unlocked, 1 when it's locked and 2 when it's locked and a thread may be
+asleep waiting for it.  A thread that has to sleep first sets the state to 2, so the holder
+knows to wake someone when it unlocks; the thread that's woken sets it to 2 again when it
+takes the mutex, since it can't tell whether anyone else is still asleep.  That costs an
+occasional unnecessary wake-up but never a lost one.
+
+Before sleeping, a thread spins in rounds:  the n'th round executes "PF_CPU_RELAX()" 2^n times
+and then looks at the state (without writing to it, so the spinning threads don't keep
+stealing the cache line from the holder) and tries to take the mutex if it's unlocked.  Most
+critical sections that are worth protecting with this kind of mutex end within the first few
+rounds.
+
+The private futex operations are used on Linux, since the addresses are never shared with
+another process.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include "platform.h"
+#include "platform/mutex.h"
+
+#if defined(__linux__)
+  #define MUTEX_FUTEX
+  #include <limits.h>
+  #include <unistd.h>
+  #include <sys/syscall.h>
+  #include <linux/futex.h>
+#elif defined(_WIN32)
+  #include <windows.h>
+  #if defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+    #define MUTEX_WAIT_ON_ADDRESS
+    #if (PF_COMPILER == PF_MICROSOFT)
+      #pragma comment(lib, "Synchronization.lib")
+    #endif
+  #endif
+#elif (PF_THREADS_API == PF_THREADS_POSIX)
+  #include <sched.h>
+#endif
+
+#if (PF_COMPILER == PF_MICROSOFT)
+  #include <intrin.h>                                                   // for "PF_CPU_RELAX()"
+#endif
+
+// ============================================================================================
+// PRIVATE MACRO DEFINITIONS
+// ============================================================================================
+
+#ifndef PF_MUTEX_SPIN_ROUNDS
+  #define PF_MUTEX_SPIN_ROUNDS 8
+#endif
+
+#if defined(MUTEX_FUTEX) && !defined(FUTEX_PRIVATE_FLAG)
+  #define FUTEX_WAIT_PRIVATE FUTEX_WAIT
+  #define FUTEX_WAKE_PRIVATE FUTEX_WAKE
+#endif
+
+// ============================================================================================
+// FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+void pf_wait_on_address
+(
+  pf_atomic32_t* address,                                                 // the value to watch
+  const int32_t  expected                                // the value that means "keep waiting"
+)
+
+/*
+This function puts the calling thread to sleep until another thread changes a value and wakes
+it.
+
+PRECONDITIONS:
+"address" must not be NULL.
+
+POSTCONDITIONS:
+If "*address" wasn't "expected" then the function returned at once.  Otherwise the thread
+slept until "pf_wake_by_address_...()" was called for "address", or for no reason at all.
+*/
+
+{
+  #if defined(MUTEX_FUTEX)
+
+    syscall(SYS_futex, (void*)address, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+
+  #elif defined(MUTEX_WAIT_ON_ADDRESS)
+
+    int32_t compare = expected;
+
+    WaitOnAddress((volatile VOID*)address, &compare, sizeof(compare), INFINITE);
+
+  #else
+
+    if (pf_atomic_load32(address, PF_MEMORY_ORDER_RELAXED) == expected)
+    {
+      #if defined(_WIN32)
+        SwitchToThread();
+      #elif (PF_THREADS_API == PF_THREADS_POSIX)
+        sched_yield();
+      #endif
+    }
+
+  #endif
+}
+
+/*********************************************************************************************/
+
+void pf_wake_by_address_single
+(
+  pf_atomic32_t* address                                                  // the value to watch
+)
+
+/*
+This function wakes one thread that's asleep in "pf_wait_on_address()" for an address.
+
+PRECONDITIONS:
+"address" must not be NULL.
+
+POSTCONDITIONS:
+One thread waiting on "address" (if any) has been woken.
+*/
+
+{
+  #if defined(MUTEX_FUTEX)
+    syscall(SYS_futex, (void*)address, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+  #elif defined(MUTEX_WAIT_ON_ADDRESS)
+    WakeByAddressSingle((PVOID)address);
+  #else
+    (void)address;
+  #endif
+}
+
+/*********************************************************************************************/
+
+void pf_wake_by_address_all
+(
+  pf_atomic32_t* address                                                  // the value to watch
+)
+
+/*
+This function wakes every thread that's asleep in "pf_wait_on_address()" for an address.
+
+PRECONDITIONS:
+"address" must not be NULL.
+
+POSTCONDITIONS:
+Every thread waiting on "address" has been woken.
+*/
+
+{
+  #if defined(MUTEX_FUTEX)
+    syscall(SYS_futex, (void*)address, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+  #elif defined(MUTEX_WAIT_ON_ADDRESS)
+    WakeByAddressAll((PVOID)address);
+  #else
+    (void)address;
+  #endif
+}
+
+namespace pf
+{
+
+/*********************************************************************************************/
+
+void adaptive_mutex::lockContended()
+
+/*
+This function locks the mutex after "lock()" has found it locked:  it spins for a while and
+then sleeps until the mutex is unlocked.
+
+PRECONDITIONS:
+The calling thread mustn't have locked the mutex already.
+
+POSTCONDITIONS:
+The mutex is locked by the calling thread.
+*/
+
+{
+  int round;
+
+  for (round = 0; round < PF_MUTEX_SPIN_ROUNDS; round++)
+  {
+    int32_t state = 0;
+    long    spins;
+
+    for (spins = 1L << round; spins > 0; spins--)
+      PF_CPU_RELAX();
+
+    if ((pf_atomic_load32(&_state, PF_MEMORY_ORDER_RELAXED) == 0) &&
+        pf_atomic_cas32(&_state, &state, 1, PF_MEMORY_ORDER_ACQUIRE))
+    {
+      return;
+    }
+  }
+
+  while (pf_atomic_exchange32(&_state, 2, PF_MEMORY_ORDER_ACQUIRE) != 0)
+    pf_wait_on_address(&_state, 2);
+}
+
+}
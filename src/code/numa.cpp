@@ -0,0 +1,466 @@
+// ============================================================================================
+//
+// numa.cpp -- NUMA Topology and Node-Local Allocation
+//
+// ============================================================================================
+
+/*
+This source file defines the routines that discover the NUMA topology and place memory on
+particular nodes.  See "numa.h" for details.
+*/
+
+// ============================================================================================
+// DESIGN NOTES
+// ============================================================================================
+
+/*
+On Linux, "/sys/devices/system/node/online" lists the online nodes as ranges ("0-1,3", for
+example).  Node numbers can have gaps, so the list is kept as a bitmask (which is what
+"mbind()" wants anyway) and the node count is one more than the highest node number.  The
+current node comes from the "getcpu()" system call and blocks are placed by calling "mbind()"
+on the pages that "pf_large_alloc()" maps, before anything touches them.  Both are called
+through "syscall()" because older C libraries don't have wrappers for them (and the wrapper
+for "mbind()" is in libnuma).  A node-local block is given the "preferred" policy rather than
+the "bind" policy, so that it spills onto other nodes instead of failing when its own node is
+full.
+
+On Windows, "VirtualAllocExNuma()" allocates on a given node.  An interleaved block is
+reserved in one piece and then committed one "PF_LARGE_PAGE_SIZE" stripe at a time, each on
+the next node in turn; it's still released by "pf_large_free()" in one piece.
+
+Everywhere else there's assumed to be one node, and the allocation routines are
+"pf_large_alloc()".
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stdio.h>
+#include <string.h>
+
+#include "platform.h"
+#include "platform/numa.h"
+
+#if defined(__linux__)
+  #define NUMA_LINUX
+  #include <unistd.h>
+  #include <sys/syscall.h>
+#elif defined(_WIN32)
+  #define NUMA_WIN32
+  #include <windows.h>
+#endif
+
+// ============================================================================================
+// PRIVATE MACRO DEFINITIONS
+// ============================================================================================
+
+// The highest number of nodes that's supported (Linux's own default limit)
+
+#define NUMA_MAX_NODES 1024
+
+#define NUMA_BITS_PER_WORD (8 * sizeof(unsigned long))
+#define NUMA_MASK_WORDS    (NUMA_MAX_NODES / NUMA_BITS_PER_WORD)
+
+// Memory policies, as numbered by Linux's "mbind()" system call
+
+#define NUMA_MPOL_PREFERRED  1
+#define NUMA_MPOL_INTERLEAVE 3
+
+// ============================================================================================
+// PRIVATE FUNCTION DECLARATIONS
+// ============================================================================================
+
+static int    detectTopology(void);
+static size_t roundUp(const size_t);
+
+#if defined(NUMA_LINUX)
+  static int  parseNodeList(const char*, unsigned long*);
+  static void placePages(void*, const size_t, const int, const unsigned long*);
+#endif
+
+// ============================================================================================
+// STATIC VARIABLE DEFINITIONS
+// ============================================================================================
+
+static int           topologyDetected = 0;                // non-zero once "nodeCount" is valid
+static unsigned long onlineNodes[NUMA_MASK_WORDS];         // a bit for each node that's online
+static int           nodeCount        = detectTopology();    // the highest node number, plus 1
+
+// ============================================================================================
+// FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+int pf_numa_node_count(void)
+
+/*
+This function determines how many NUMA nodes the computer has.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+One more than the highest node number is returned (at least 1).
+*/
+
+{
+  if (!topologyDetected)
+    nodeCount = detectTopology();
+
+  return nodeCount;
+}
+
+/*********************************************************************************************/
+
+int pf_numa_current_node(void)
+
+/*
+This function determines which NUMA node the calling thread is running on.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The node number is returned, or 0 if it can't be determined.  The operating system may move
+the thread to another node at any time unless its affinity prevents it.
+*/
+
+{
+  #if defined(NUMA_LINUX) && defined(SYS_getcpu)
+
+    unsigned cpu;
+    unsigned node;
+
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0)
+      return (int)node;
+
+  #elif defined(NUMA_WIN32)
+
+    UCHAR node;
+
+    if (GetNumaProcessorNode((UCHAR)GetCurrentProcessorNumber(), &node) && (node != 0xFF))
+      return node;
+
+  #endif
+
+  return 0;
+}
+
+/*********************************************************************************************/
+
+void* pf_numa_alloc_on_node
+(
+  const size_t size,                                              // the block's size, in bytes
+  const int    node,                                                 // the node to place it on
+  int*         tier                      // receives a "PF_LARGE_PAGES_..." value (may be NULL)
+)
+
+/*
+This function allocates a large block of memory on a particular NUMA node.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+As for "pf_large_alloc()".  If "node" isn't a valid node number then the block is allocated
+wherever the operating system chooses.
+*/
+
+{
+  void* block = NULL;
+
+  if ((node < 0) || (node >= pf_numa_node_count()))
+    return pf_large_alloc(size, tier);
+
+  #if defined(NUMA_LINUX)
+
+    block = pf_large_alloc(size, tier);
+
+    if (block != NULL)
+    {
+      unsigned long mask[NUMA_MASK_WORDS];
+
+      memset(mask, 0, sizeof(mask));
+      mask[node / NUMA_BITS_PER_WORD] = 1UL << (node % NUMA_BITS_PER_WORD);
+      placePages(block, roundUp(size), NUMA_MPOL_PREFERRED, mask);
+    }
+
+  #elif defined(NUMA_WIN32)
+
+    const size_t rounded = roundUp(size);
+
+    if ((size > 0) && (rounded >= size))
+    {
+      block = VirtualAllocExNuma(GetCurrentProcess(), NULL, rounded, MEM_RESERVE | MEM_COMMIT,
+                                 PAGE_READWRITE, (DWORD)node);
+    }
+
+    if (block == NULL)
+      return pf_large_alloc(size, tier);
+
+    if (tier != NULL)
+      *tier = PF_LARGE_PAGES_NORMAL;
+
+  #else
+
+    block = pf_large_alloc(size, tier);
+
+  #endif
+
+  return block;
+}
+
+/*********************************************************************************************/
+
+void* pf_numa_alloc_interleaved
+(
+  const size_t size,                                              // the block's size, in bytes
+  int*         tier                      // receives a "PF_LARGE_PAGES_..." value (may be NULL)
+)
+
+/*
+This function allocates a large block of memory whose pages are spread evenly across every
+NUMA node.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+As for "pf_large_alloc()".
+*/
+
+{
+  void* block = NULL;
+
+  if (pf_numa_node_count() < 2)
+    return pf_large_alloc(size, tier);
+
+  #if defined(NUMA_LINUX)
+
+    block = pf_large_alloc(size, tier);
+
+    if (block != NULL)
+      placePages(block, roundUp(size), NUMA_MPOL_INTERLEAVE, onlineNodes);
+
+  #elif defined(NUMA_WIN32)
+
+    const size_t rounded = roundUp(size);
+    size_t       offset;
+
+    if ((size > 0) && (rounded >= size))
+      block = VirtualAlloc(NULL, rounded, MEM_RESERVE, PAGE_READWRITE);
+
+    if (block == NULL)
+      return pf_large_alloc(size, tier);
+
+    for (offset = 0; offset < rounded; offset += PF_LARGE_PAGE_SIZE)
+    {
+      char* const stripe = (char*)block + offset;
+      const DWORD node   = (DWORD)((offset / PF_LARGE_PAGE_SIZE) % nodeCount);
+
+      if ((VirtualAllocExNuma(GetCurrentProcess(), stripe, PF_LARGE_PAGE_SIZE, MEM_COMMIT,
+                              PAGE_READWRITE, node) == NULL) &&
+          (VirtualAlloc(stripe, PF_LARGE_PAGE_SIZE, MEM_COMMIT, PAGE_READWRITE) == NULL))
+      {
+        VirtualFree(block, 0, MEM_RELEASE);
+        return pf_large_alloc(size, tier);
+      }
+    }
+
+    if (tier != NULL)
+      *tier = PF_LARGE_PAGES_NORMAL;
+
+  #else
+
+    block = pf_large_alloc(size, tier);
+
+  #endif
+
+  return block;
+}
+
+// ============================================================================================
+// PRIVATE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+static int detectTopology(void)
+
+/*
+This function reads the NUMA topology and records which nodes are online in "onlineNodes".
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+One more than the highest node number is returned (at least 1).
+*/
+
+{
+  int count = 1;
+
+  memset(onlineNodes, 0, sizeof(onlineNodes));
+  onlineNodes[0] = 1;
+
+  #if defined(NUMA_LINUX)
+
+    FILE* file = fopen("/sys/devices/system/node/online", "r");
+
+    if (file != NULL)
+    {
+      char          list[256];
+      unsigned long mask[NUMA_MASK_WORDS];
+
+      if (fgets(list, sizeof(list), file) != NULL)
+      {
+        const int highest = parseNodeList(list, mask);
+
+        if (highest > 0)
+        {
+          memcpy(onlineNodes, mask, sizeof(onlineNodes));
+          count = highest;
+        }
+      }
+
+      fclose(file);
+    }
+
+  #elif defined(NUMA_WIN32)
+
+    ULONG highest;
+
+    if (GetNumaHighestNodeNumber(&highest) && (highest < NUMA_MAX_NODES))
+    {
+      ULONG node;
+
+      count = (int)highest + 1;
+
+      for (node = 0; node <= highest; node++)
+        onlineNodes[node / NUMA_BITS_PER_WORD] |= 1UL << (node % NUMA_BITS_PER_WORD);
+    }
+
+  #endif
+
+  topologyDetected = 1;
+  return count;
+}
+
+/*********************************************************************************************/
+
+static size_t roundUp
+(
+  const size_t size                                                        // the size to round
+)
+
+/*
+This function rounds a size up to a multiple of "PF_LARGE_PAGE_SIZE", as "pf_large_alloc()"
+does.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The rounded size is returned.  If it can't be represented then a value less than "size" is
+returned.
+*/
+
+{
+  return ((size + PF_LARGE_PAGE_SIZE - 1) / PF_LARGE_PAGE_SIZE) * PF_LARGE_PAGE_SIZE;
+}
+
+/*********************************************************************************************/
+
+#if defined(NUMA_LINUX)
+
+static int parseNodeList
+(
+  const char*    list,                                              // a list such as "0-1,3\n"
+  unsigned long* mask                                    // receives a bit for each listed node
+)
+
+/*
+This function parses a Linux node (or CPU) list.
+
+PRECONDITIONS:
+"list" and "mask" must not be NULL, and "mask" must have room for "NUMA_MAX_NODES" bits.
+
+POSTCONDITIONS:
+One more than the highest listed number is returned, or 0 if the list is empty or malformed.
+Numbers of "NUMA_MAX_NODES" or more are ignored.
+*/
+
+{
+  int highest = 0;
+
+  memset(mask, 0, NUMA_MASK_WORDS * sizeof(unsigned long));
+
+  while ((*list >= '0') && (*list <= '9'))
+  {
+    int first = 0;
+    int last;
+
+    while ((*list >= '0') && (*list <= '9') && (first < NUMA_MAX_NODES))
+      first = (first * 10) + (*list++ - '0');
+
+    last = first;
+
+    if (*list == '-')
+    {
+      list++;
+      last = 0;
+
+      while ((*list >= '0') && (*list <= '9') && (last < NUMA_MAX_NODES))
+        last = (last * 10) + (*list++ - '0');
+    }
+
+    for (; (first <= last) && (first < NUMA_MAX_NODES); first++)
+    {
+      mask[first / NUMA_BITS_PER_WORD] |= 1UL << (first % NUMA_BITS_PER_WORD);
+
+      if (first >= highest)
+        highest = first + 1;
+    }
+
+    if (*list == ',')
+      list++;
+  }
+
+  return highest;
+}
+
+/*********************************************************************************************/
+
+static void placePages
+(
+  void*                block,                                             // the pages to place
+  const size_t         size,                                            // their size, in bytes
+  const int            policy,                                       // a "NUMA_MPOL_..." value
+  const unsigned long* mask                                                 // the nodes to use
+)
+
+/*
+This function sets the memory policy of pages that haven't been touched yet.
+
+PRECONDITIONS:
+"block" must be page-aligned and "mask" must have "NUMA_MAX_NODES" bits.
+
+POSTCONDITIONS:
+The policy is set if the kernel supports NUMA.  Failure is ignored:  the pages are then placed
+by the default policy.
+*/
+
+{
+  #if defined(SYS_mbind)
+    syscall(SYS_mbind, block, size, policy, mask, (unsigned long)NUMA_MAX_NODES + 1, 0);
+  #else
+    (void)block;
+    (void)size;
+    (void)policy;
+    (void)mask;
+  #endif
+}
+
+#endif
@@ -0,0 +1,364 @@
+// ============================================================================================
+//
+// pool.cpp -- Fixed-Size Block Pools
+//
+// ============================================================================================
+
+/*
+This source file defines the out-of-line members of "pf::pool_base".  See "pool.h" for
+details.
+*/
+
+// ============================================================================================
+// DESIGN NOTES
+// ============================================================================================
+
+/*
+Each per-thread cache is guarded by a flag that's set with an atomic exchange.  A thread picks
+a cache by hashing the address of a thread-local variable (so each thread usually gets the
+same cache, and different threads usually get different ones); if that cache is busy then the
+next one is tried, and so on, so correctness never depends on two threads getting different
+caches.  The flag is only held for a few instructions (or while a new slab is allocated), so
+waiting for one is never long.
+
+The shared free list is a lock-free stack.  Blocks are only ever pushed onto it one at a time
+and taken off it all at once (with an atomic exchange), which avoids the ABA problem that
+popping single blocks would have.  An empty cache takes the whole shared list, and a cache
+that has had more than "POOL_CACHE_LIMIT" blocks freed into it since then passes further
+frees on to the shared list, so blocks freed by one thread find their way to the threads that
+are allocating them.
+
+Slabs are pushed onto a lock-free list of their own, which is only read by the destructor.
+
+The atomic operations come from <platform/atomic.h>.  Without thread-local variables, the
+address of a local variable is hashed instead (threads' stacks are different too).
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include "platform.h"
+#include "platform/pool.h"
+
+// ============================================================================================
+// PRIVATE MACRO DEFINITIONS
+// ============================================================================================
+
+// The number of blocks that a cache keeps before passing frees on to the shared list
+
+#define POOL_CACHE_LIMIT 64
+
+// ============================================================================================
+// PRIVATE FUNCTION DECLARATIONS
+// ============================================================================================
+
+static void   pushPointer(pf_atomic_ptr_t*, void*, void**);
+static size_t threadHash(void);
+
+// ============================================================================================
+// STATIC VARIABLE DEFINITIONS
+// ============================================================================================
+
+// Only the address of "threadMarker" (which is different for each thread) is used
+
+#ifdef PF_THREAD_LOCAL
+  static PF_THREAD_LOCAL PF_TLS_INITIAL_EXEC char threadMarker;
+#endif
+
+namespace pf
+{
+
+// ============================================================================================
+// FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+pool_base::pool_base
+(
+  const size_t blockSize,                               // the size of the objects to be pooled
+  const size_t slabSize                                         // the size of a slab, in bytes
+):
+  _blockSize(sizeof(block)),
+  _slabSize(slabSize),
+  _free(NULL),
+  _slabs(NULL)
+
+/*
+This constructor creates an empty pool.  No memory is allocated until the first block is.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The pool is empty.  Its block size is "blockSize" rounded up as described in "pool.h".
+*/
+
+{
+  int index;
+
+  if (blockSize > PF_CACHE_LINE_SIZE)
+  {
+    _blockSize = ((blockSize + PF_CACHE_LINE_SIZE - 1) / PF_CACHE_LINE_SIZE) *
+                 PF_CACHE_LINE_SIZE;
+  }
+  else
+  {
+    while (_blockSize < blockSize)
+      _blockSize *= 2;
+  }
+
+  if (_slabSize < PF_CACHE_LINE_SIZE + _blockSize)
+    _slabSize = PF_CACHE_LINE_SIZE + _blockSize;
+
+  if (_slabSize >= PF_LARGE_PAGE_SIZE)
+  {
+    _slabSize = ((_slabSize + PF_LARGE_PAGE_SIZE - 1) / PF_LARGE_PAGE_SIZE) *
+                PF_LARGE_PAGE_SIZE;
+  }
+
+  for (index = 0; index < PF_POOL_CACHES; index++)
+  {
+    pf_atomic_store_ptr(&_caches[index]->busy, NULL, PF_MEMORY_ORDER_RELAXED);
+    _caches[index]->head  = NULL;
+    _caches[index]->count = 0;
+  }
+}
+
+/*********************************************************************************************/
+
+pool_base::~pool_base()
+
+/*
+This destructor returns every slab to the operating system (or heap).
+
+PRECONDITIONS:
+Every block allocated from the pool must have been freed, and no other thread may be using
+the pool.
+
+POSTCONDITIONS:
+The pool's memory is freed.
+*/
+
+{
+  void* slab = pf_atomic_load_ptr(&_slabs, PF_MEMORY_ORDER_ACQUIRE);
+
+  while (slab != NULL)
+  {
+    void* const next = *(void**)slab;
+
+    if (_slabSize >= PF_LARGE_PAGE_SIZE)
+      pf_large_free(slab, _slabSize);
+    else
+      pf_aligned_free(slab);
+
+    slab = next;
+  }
+}
+
+/*********************************************************************************************/
+
+void* pool_base::allocate()
+
+/*
+This function allocates a block from the pool.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+A pointer to a block of "block_size()" bytes, aligned to the smaller of "block_size()" and
+"PF_CACHE_LINE_SIZE", is returned, or NULL if a new slab was needed and couldn't be
+allocated.
+*/
+
+{
+  cache* const local = lockCache();
+  block*       result;
+
+  if (local->head == NULL)
+  {
+    local->head  = (block*)pf_atomic_exchange_ptr(&_free, NULL, PF_MEMORY_ORDER_ACQUIRE);
+    local->count = 0;
+  }
+
+  result = (local->head != NULL) ? local->head : grow(local);
+
+  if (result != NULL)
+    local->head = result->next;
+
+  if (local->count > 0)
+    local->count--;
+
+  pf_atomic_store_ptr(&local->busy, NULL, PF_MEMORY_ORDER_RELEASE);
+  return result;
+}
+
+/*********************************************************************************************/
+
+void pool_base::deallocate
+(
+  void* freed                                                              // the block to free
+)
+
+/*
+This function returns a block to the pool.
+
+PRECONDITIONS:
+"freed" must be NULL or have been returned by "allocate()" on this pool (and not freed since).
+
+POSTCONDITIONS:
+The block is available to be allocated again.  Nothing is done if "freed" is NULL.
+*/
+
+{
+  cache* local;
+
+  if (freed == NULL)
+    return;
+
+  local = lockCache();
+
+  if (local->count < POOL_CACHE_LIMIT)
+  {
+    ((block*)freed)->next = local->head;
+    local->head           = (block*)freed;
+    local->count++;
+  }
+  else
+  {
+    pushPointer(&_free, freed, (void**)&((block*)freed)->next);
+  }
+
+  pf_atomic_store_ptr(&local->busy, NULL, PF_MEMORY_ORDER_RELEASE);
+}
+
+/*********************************************************************************************/
+
+pool_base::cache* pool_base::lockCache()
+
+/*
+This function gains exclusive use of a per-thread cache, preferably the calling thread's own.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+A pointer to the cache is returned.  The caller must release it by storing NULL in its "busy"
+flag (with release ordering).
+*/
+
+{
+  size_t index = threadHash() % PF_POOL_CACHES;
+
+  while (pf_atomic_exchange_ptr(&_caches[index]->busy, this, PF_MEMORY_ORDER_ACQUIRE) != NULL)
+    index = (index + 1) % PF_POOL_CACHES;
+
+  return &*_caches[index];
+}
+
+/*********************************************************************************************/
+
+pool_base::block* pool_base::grow
+(
+  cache* local                                   // the (locked) cache to put the new blocks in
+)
+
+/*
+This function allocates a new slab and carves it into blocks.
+
+PRECONDITIONS:
+"local" must be locked and empty.
+
+POSTCONDITIONS:
+The first block is returned and "local->head" points to the rest, or NULL is returned if the
+slab couldn't be allocated.
+*/
+
+{
+  char*  slab;
+  size_t count    = (_slabSize - PF_CACHE_LINE_SIZE) / _blockSize;
+  block* previous = NULL;
+
+  if (_slabSize >= PF_LARGE_PAGE_SIZE)
+    slab = (char*)pf_large_alloc(_slabSize, NULL);
+  else
+    slab = (char*)pf_aligned_alloc(_slabSize, PF_CACHE_LINE_SIZE);
+
+  if (slab == NULL)
+    return NULL;
+
+  while (count > 0)                          // the first cache line holds the slab list's link
+  {
+    block* const current = (block*)(slab + PF_CACHE_LINE_SIZE + (--count * _blockSize));
+
+    current->next = previous;
+    previous      = current;
+  }
+
+  pushPointer(&_slabs, slab, (void**)slab);
+  local->head = previous;
+  return previous;
+}
+
+}
+
+// ============================================================================================
+// PRIVATE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+static void pushPointer
+(
+  pf_atomic_ptr_t* head,                                       // the head of a lock-free stack
+  void*            item,                                                    // the item to push
+  void**           link                                            // the item's "next" pointer
+)
+
+/*
+This function pushes an item onto a lock-free stack.
+
+PRECONDITIONS:
+"head" and "link" must not be NULL, and no other thread may be using "item".
+
+POSTCONDITIONS:
+"item" is at the top of the stack.
+*/
+
+{
+  void* top = pf_atomic_load_ptr(head, PF_MEMORY_ORDER_RELAXED);
+
+  do
+    *link = top;
+  while (!pf_atomic_cas_ptr(head, &top, item, PF_MEMORY_ORDER_RELEASE));
+}
+
+/*********************************************************************************************/
+
+static size_t threadHash(void)
+
+/*
+This function returns a number that's usually the same for every call made by one thread and
+usually different for calls made by different threads.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The number is returned.
+*/
+
+{
+  #ifdef PF_THREAD_LOCAL
+    size_t hash = (size_t)&threadMarker;
+  #else
+    char   marker;
+    size_t hash = (size_t)&marker;                        // each thread has a stack of its own
+  #endif
+
+  hash >>= 6;
+  hash  ^= (hash >> 7) ^ (hash >> 13) ^ (hash >> 19);
+  return hash;
+}
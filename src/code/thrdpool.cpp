@@ -0,0 +1,797 @@
+// ============================================================================================
+//
+// thrdpool.cpp -- Work-Stealing Thread Pools
+//
+// ============================================================================================
+
+/*
+This source file defines the out-of-line members of "pf::thread_pool".  See "thrdpool.h" for
+details.
+*/
+
+// ============================================================================================
+// DESIGN NOTES
+// ============================================================================================
+
+/*
+The deques are the fixed-size version of the Chase-Lev deque, with the memory orderings given
+by Le, Pop, Cohen and Zappa Nardelli ("Correct and Efficient Work-Stealing for Weak Memory
+Models", 2013).  The owner pushes and pops at the bottom and thieves take from the top; only a
+pop that races a steal for the last task needs a compare-exchange.  A deque holds pointers to
+tasks (which come from a "pf::pool") rather than the tasks themselves, so that a thief never
+reads a task that the owner is overwriting.  A thread only pushes the halves that it splits
+off, so its deque never holds more than about 64 tasks; if it's ever full then the thread
+simply stops splitting.
+
+A job counts the items that haven't been run yet.  The thread whose subrange brings the count
+to 0 marks the job finished, and wakes the thread that's waiting for it if that thread has
+gone to sleep.  The waiting thread runs (or steals) tasks in the meantime, so it's never idle
+while there's work that it could do; since tasks are taken from the top of other deques, it
+may well run part of another job.  The job lives on the waiting thread's stack, and that
+thread may return as soon as it sees the job finished, so the last thread can wake an address
+that's no longer the job's.  That's harmless:  waits can return spuriously anyway.
+
+A worker with nothing to do registers itself as sleeping, then checks every deque once more
+before going to sleep on "_epoch"; a thread that pushes a task checks for sleeping workers
+after pushing it and changes "_epoch" before waking one.  Both checks follow a sequentially-
+consistent fence, so either the worker sees the task or the pusher sees the worker (and the
+worker's wait returns at once if "_epoch" changes first), and a task is never stranded while
+every worker sleeps.
+
+A reduction needs an array of per-thread partial results.  Rather than allocating one every
+time, the pool keeps the last one ("_spareResults", with its size in its first cache line) and
+hands it to the next reduction if it's big enough.  Taking it is an exchange with NULL, so a
+nested or concurrent reduction finds no spare and allocates its own; giving it back is a
+compare-exchange with NULL, and the loser frees its block.
+
+Non-worker threads share deque 0, so they take turns with "_callerLock".  A thread-local
+variable records which deque (if any) the current thread owns, so that a body can start a
+nested job without taking the lock again.  A job that a body starts on a different pool saves
+and restores that variable, so the body can still start nested jobs on its own pool.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include "platform.h"
+#include "platform/affinity.h"
+#include "platform/thrdpool.h"
+
+#if (PF_THREADS_API == PF_THREADS_POSIX)
+  #include <pthread.h>
+#elif (PF_THREADS_API == PF_THREADS_WIN32)
+  #include <windows.h>
+  #include <process.h>
+#elif (PF_THREADS_API == PF_THREADS_CPP11)
+  #include <thread>
+#endif
+
+#if (PF_COMPILER == PF_MICROSOFT)
+  #include <intrin.h>                                                   // for "PF_CPU_RELAX()"
+#endif
+
+// ============================================================================================
+// PRIVATE MACRO DEFINITIONS
+// ============================================================================================
+
+// The number of tasks that a deque can hold (a power of 2)
+
+#define THRDPOOL_DEQUE_SIZE 256
+
+// The number of times that an idle thread looks for work before it sleeps
+
+#define THRDPOOL_IDLE_SPINS 256
+
+// ============================================================================================
+// STATIC VARIABLE DEFINITIONS
+// ============================================================================================
+
+// The calling thread's deque, if it's one of a pool's threads
+
+#ifdef PF_THREAD_LOCAL
+  static PF_THREAD_LOCAL PF_TLS_INITIAL_EXEC void* currentDeque = NULL;
+#endif
+
+namespace pf
+{
+
+// ============================================================================================
+// PRIVATE TYPE DEFINITIONS
+// ============================================================================================
+
+#if (PF_THREADS_API == PF_THREADS_POSIX)
+  typedef pthread_t   thrdpool_thread;
+#elif (PF_THREADS_API == PF_THREADS_WIN32)
+  typedef HANDLE      thrdpool_thread;
+#elif (PF_THREADS_API == PF_THREADS_CPP11)
+  typedef std::thread thrdpool_thread;
+#endif
+
+struct thread_pool::deque
+{
+  struct end
+  {
+    pf_atomic64_t index;                                   // the position of a task in "tasks"
+  };
+
+  padded<end>     top;                                   // the next task to steal (by thieves)
+  padded<end>     bottom;                              // one past the last task (by the owner)
+  pf_atomic_ptr_t tasks[THRDPOOL_DEQUE_SIZE];                                      // the tasks
+  thread_pool*    owner;                                              // the pool it belongs to
+  unsigned        slot;                                                // its index in the pool
+  unsigned        seed;                                    // for choosing victims (owner only)
+
+  bool  push(task*);
+  task* pop();
+  task* steal();
+
+  #if (PF_THREADS_API == PF_THREADS_POSIX)
+    static void* start(void* self)
+    {
+      ((deque*)self)->owner->workerLoop((deque*)self);
+      return NULL;
+    }
+  #elif (PF_THREADS_API == PF_THREADS_WIN32)
+    static unsigned __stdcall start(void* self)
+    {
+      ((deque*)self)->owner->workerLoop((deque*)self);
+      return 0;
+    }
+  #elif (PF_THREADS_API == PF_THREADS_CPP11)
+    static void start(deque* self) {self->owner->workerLoop(self);}
+  #endif
+};
+
+// ============================================================================================
+// FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+thread_pool::thread_pool
+(
+  const unsigned threads                      // the number of threads to use (0 = one per CPU)
+):
+  _size(1),
+  _deques(NULL),
+  _threads(NULL),
+  _tasks(PF_POOL_SLAB_SIZE)
+
+/*
+This constructor creates a pool and starts its worker threads.  The thread that runs a loop
+counts as one of the threads, so one fewer workers are started.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The pool is ready to run loops.  If the workers can't be started (or "PF_THREADS_API" is
+"PF_THREADS_NONE") then "size()" is 1 and loops run on the calling thread alone.
+*/
+
+{
+  const unsigned count = (threads > 0) ? threads : (unsigned)pf_cpu_count();
+
+  pf_atomic_store_ptr(&_spareResults, NULL, PF_MEMORY_ORDER_RELAXED);
+  pf_atomic_store32(&_epoch, 0, PF_MEMORY_ORDER_RELAXED);
+  pf_atomic_store32(&_sleeping, 0, PF_MEMORY_ORDER_RELAXED);
+  pf_atomic_store32(&_stop, 0, PF_MEMORY_ORDER_RELAXED);
+
+  #if (PF_THREADS_API != PF_THREADS_NONE)
+
+    thrdpool_thread* workers = NULL;
+    unsigned         slot;
+
+    if (count < 2)
+      return;
+
+    _deques = (deque*)pf_aligned_alloc(count * sizeof(deque), PF_CACHE_LINE_SIZE);
+
+    if (_deques != NULL)
+      workers = new (std::nothrow) thrdpool_thread[count - 1];
+
+    if (workers == NULL)
+    {
+      pf_aligned_free(_deques);
+      _deques = NULL;
+      return;
+    }
+
+    for (slot = 0; slot < count; slot++)
+    {
+      deque* const own = new (&_deques[slot]) deque();
+
+      pf_atomic_store64(&own->top->index, 0, PF_MEMORY_ORDER_RELAXED);
+      pf_atomic_store64(&own->bottom->index, 0, PF_MEMORY_ORDER_RELAXED);
+      own->owner = this;
+      own->slot  = slot;
+      own->seed  = slot + 1;
+    }
+
+    _size    = count;
+    _threads = workers;
+
+    for (slot = 1; slot < count; slot++)
+    {
+      #if (PF_THREADS_API == PF_THREADS_POSIX)
+
+        if (pthread_create(&workers[slot - 1], NULL, &deque::start, &_deques[slot]) != 0)
+          break;
+
+      #elif (PF_THREADS_API == PF_THREADS_WIN32)
+
+        workers[slot - 1] = (HANDLE)_beginthreadex(NULL, 0, &deque::start, &_deques[slot], 0,
+                                                   NULL);
+
+        if (workers[slot - 1] == NULL)
+          break;
+
+      #elif (PF_THREADS_API == PF_THREADS_CPP11)
+
+        try
+        {
+          workers[slot - 1] = std::thread(&deque::start, &_deques[slot]);
+        }
+        catch (...)
+        {
+          break;
+        }
+
+      #endif
+    }
+
+    if (slot < count)                                   // run everything on the caller instead
+    {
+      stopWorkers(slot - 1);
+      pf_aligned_free(_deques);
+      _deques = NULL;
+      _size   = 1;
+    }
+
+  #else
+
+    (void)count;
+
+  #endif
+}
+
+/*********************************************************************************************/
+
+thread_pool::~thread_pool()
+
+/*
+This destructor stops the pool's worker threads.
+
+PRECONDITIONS:
+No loop may be running on the pool.
+
+POSTCONDITIONS:
+The worker threads have exited.
+*/
+
+{
+  if (_deques != NULL)
+  {
+    stopWorkers(_size - 1);
+    pf_aligned_free(_deques);
+  }
+
+  pf_aligned_free(pf_atomic_load_ptr(&_spareResults, PF_MEMORY_ORDER_RELAXED));
+}
+
+/*********************************************************************************************/
+
+void thread_pool::run
+(
+  job&         work,                                                          // the job to run
+  const size_t begin,                                                  // the first item to run
+  const size_t end                                                     // one past the last one
+)
+
+/*
+This function runs a job on the pool and waits for it to finish.
+
+PRECONDITIONS:
+"work.call" and "work.grain" must be set, and "begin" must be no greater than "end".
+
+POSTCONDITIONS:
+"work.call" has been called for subranges that cover ["begin", "end").
+*/
+
+{
+  deque* own      = NULL;
+  bool   external = true;
+  int    spins    = 0;
+  task   next;
+
+  #ifdef PF_THREAD_LOCAL
+    void* const outer = currentDeque;                      // restored when the job is finished
+  #endif
+
+  if (begin >= end)
+    return;
+
+  if (_size < 2)
+  {
+    size_t first = begin;
+
+    while (first < end)
+    {
+      const size_t last = (end - first > work.grain) ? first + work.grain : end;
+
+      work.call(&work, first, last, 0);
+      first = last;
+    }
+
+    return;
+  }
+
+  #ifdef PF_THREAD_LOCAL
+    own      = (deque*)outer;
+    external = (own == NULL) || (own->owner != this);
+  #endif
+
+  if (external)
+  {
+    _callerLock.lock();
+    own = &_deques[0];
+
+    #ifdef PF_THREAD_LOCAL
+      currentDeque = own;
+    #endif
+  }
+
+  pf_atomic_store64(&work.remaining, (int64_t)(end - begin), PF_MEMORY_ORDER_RELAXED);
+  pf_atomic_store32(&work.done, 0, PF_MEMORY_ORDER_RELAXED);
+  execute(own, &work, begin, end);
+
+  while (pf_atomic_load32(&work.done, PF_MEMORY_ORDER_ACQUIRE) != 2)
+  {
+    int32_t state = 0;
+
+    if (findTask(own, next))
+    {
+      execute(own, next.work, next.begin, next.end);
+      spins = 0;
+    }
+    else if (++spins < THRDPOOL_IDLE_SPINS)
+    {
+      PF_CPU_RELAX();
+    }
+    else if (pf_atomic_cas32(&work.done, &state, 1, PF_MEMORY_ORDER_ACQ_REL) || (state == 1))
+    {
+      pf_wait_on_address(&work.done, 1);
+    }
+  }
+
+  if (external)
+  {
+    #ifdef PF_THREAD_LOCAL
+      currentDeque = outer;                        // the deque of another pool, if it's nested
+    #endif
+
+    _callerLock.unlock();
+  }
+}
+
+/*********************************************************************************************/
+
+void thread_pool::execute
+(
+  deque* own,                                                     // the calling thread's deque
+  job*   work,                                                          // the job it's part of
+  size_t begin,                                                        // the first item to run
+  size_t end                                                           // one past the last one
+)
+
+/*
+This function runs a subrange of a job, pushing halves of it onto the calling thread's deque
+for other threads to steal until what's left is no longer than the job's grain.
+
+PRECONDITIONS:
+"own" must be the calling thread's deque and "begin" must be less than "end".
+
+POSTCONDITIONS:
+The subrange has been run or pushed, and the job is marked finished if it's the last part of
+it.
+*/
+
+{
+  size_t count;
+
+  while (end - begin > work->grain)
+  {
+    const size_t middle = begin + ((end - begin) / 2);
+    task* const  upper  = _tasks.allocate();
+
+    if (upper == NULL)
+      break;
+
+    upper->work  = work;
+    upper->begin = middle;
+    upper->end   = end;
+
+    if (!own->push(upper))                      // "upper" may be stolen as soon as it's pushed
+    {
+      _tasks.deallocate(upper);
+      break;
+    }
+
+    end = middle;
+    wakeWorker();
+  }
+
+  count = end - begin;
+
+  while (begin < end)
+  {
+    const size_t last = (end - begin > work->grain) ? begin + work->grain : end;
+
+    work->call(work, begin, last, own->slot);
+    begin = last;
+  }
+
+  if (pf_atomic_fetch_add64(&work->remaining, -(int64_t)count, PF_MEMORY_ORDER_ACQ_REL) ==
+      (int64_t)count)
+  {
+    if (pf_atomic_exchange32(&work->done, 2, PF_MEMORY_ORDER_ACQ_REL) == 1)
+      pf_wake_by_address_all(&work->done);
+  }
+}
+
+/*********************************************************************************************/
+
+bool thread_pool::findTask
+(
+  deque* own,                                                     // the calling thread's deque
+  task&  found                                                             // receives the task
+)
+
+/*
+This function takes a task from the calling thread's deque or, if it's empty, steals one from
+another thread's deque.
+
+PRECONDITIONS:
+"own" must be the calling thread's deque.
+
+POSTCONDITIONS:
+If a task was found then it's been copied to "found" (and its memory freed) and true is
+returned.  Otherwise false is returned.
+*/
+
+{
+  task*    item = own->pop();
+  unsigned offset;
+
+  if (item == NULL)
+  {
+    const unsigned start = (own->seed = (own->seed * 1103515245U) + 12345U) >> 16;
+
+    for (offset = 0; (item == NULL) && (offset < _size); offset++)
+    {
+      const unsigned victim = (start + offset) % _size;
+
+      if (victim != own->slot)
+        item = _deques[victim].steal();
+    }
+  }
+
+  if (item == NULL)
+    return false;
+
+  found = *item;
+  _tasks.deallocate(item);
+  return true;
+}
+
+/*********************************************************************************************/
+
+void thread_pool::wakeWorker()
+
+/*
+This function wakes a sleeping worker (if there is one) after a task has been pushed.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+If any worker was registered as sleeping then one of them has been woken.
+*/
+
+{
+  pf_fence_seq_cst();
+
+  if (pf_atomic_load32(&_sleeping, PF_MEMORY_ORDER_RELAXED) > 0)
+  {
+    pf_atomic_fetch_add32(&_epoch, 1, PF_MEMORY_ORDER_RELEASE);
+    pf_wake_by_address_single(&_epoch);
+  }
+}
+
+/*********************************************************************************************/
+
+void thread_pool::workerLoop
+(
+  deque* own                                                          // the worker's own deque
+)
+
+/*
+This function is the body of a worker thread:  it runs tasks until the pool is destroyed.
+
+PRECONDITIONS:
+"own" must be one of the pool's deques and no other worker may be using it.
+
+POSTCONDITIONS:
+"_stop" is non-zero.
+*/
+
+{
+  int  spins = 0;
+  task next;
+
+  #ifdef PF_THREAD_LOCAL
+    currentDeque = own;
+  #endif
+
+  for (;;)
+  {
+    if (findTask(own, next))
+    {
+      execute(own, next.work, next.begin, next.end);
+      spins = 0;
+    }
+    else if (pf_atomic_load32(&_stop, PF_MEMORY_ORDER_ACQUIRE))
+    {
+      break;
+    }
+    else if (++spins < THRDPOOL_IDLE_SPINS)
+    {
+      PF_CPU_RELAX();
+    }
+    else
+    {
+      const int32_t epoch = pf_atomic_load32(&_epoch, PF_MEMORY_ORDER_ACQUIRE);
+      unsigned      slot;
+
+      pf_atomic_fetch_add32(&_sleeping, 1, PF_MEMORY_ORDER_SEQ_CST);
+      pf_fence_seq_cst();
+
+      for (slot = 0; slot < _size; slot++)
+      {
+        if (pf_atomic_load64(&_deques[slot].top->index, PF_MEMORY_ORDER_RELAXED) <
+            pf_atomic_load64(&_deques[slot].bottom->index, PF_MEMORY_ORDER_RELAXED))
+        {
+          break;
+        }
+      }
+
+      if ((slot == _size) && !pf_atomic_load32(&_stop, PF_MEMORY_ORDER_ACQUIRE))
+        pf_wait_on_address(&_epoch, epoch);
+
+      pf_atomic_fetch_add32(&_sleeping, -1, PF_MEMORY_ORDER_RELAXED);
+      spins = 0;
+    }
+  }
+}
+
+/*********************************************************************************************/
+
+void thread_pool::stopWorkers
+(
+  const unsigned count                                         // the number of workers started
+)
+
+/*
+This function tells the worker threads to exit and waits for them to do so.
+
+PRECONDITIONS:
+No loop may be running on the pool, and workers 1 to "count" (only) must have been started.
+
+POSTCONDITIONS:
+The workers have exited and "_threads" has been freed.
+*/
+
+{
+  pf_atomic_store32(&_stop, 1, PF_MEMORY_ORDER_RELEASE);
+  pf_atomic_fetch_add32(&_epoch, 1, PF_MEMORY_ORDER_RELEASE);
+  pf_wake_by_address_all(&_epoch);
+
+  #if (PF_THREADS_API != PF_THREADS_NONE)
+
+    thrdpool_thread* const workers = (thrdpool_thread*)_threads;
+    unsigned               index;
+
+    for (index = 0; index < count; index++)
+    {
+      #if (PF_THREADS_API == PF_THREADS_POSIX)
+        pthread_join(workers[index], NULL);
+      #elif (PF_THREADS_API == PF_THREADS_WIN32)
+        WaitForSingleObject(workers[index], INFINITE);
+        CloseHandle(workers[index]);
+      #elif (PF_THREADS_API == PF_THREADS_CPP11)
+        workers[index].join();
+      #endif
+    }
+
+    delete[] workers;
+
+  #else
+
+    (void)count;
+
+  #endif
+
+  _threads = NULL;
+}
+
+/*********************************************************************************************/
+
+void* thread_pool::takeResults
+(
+  const size_t size                                  // the size of the results array, in bytes
+)
+
+/*
+This function gets memory for a reduction's partial results, reusing the pool's spare block if
+it's big enough.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+A block of at least "size" bytes, aligned to "PF_CACHE_LINE_SIZE", is returned, or NULL if one
+couldn't be allocated.  It must be passed to "giveResults()" afterwards.
+*/
+
+{
+  void* block = pf_atomic_exchange_ptr(&_spareResults, NULL, PF_MEMORY_ORDER_ACQUIRE);
+
+  if ((block != NULL) && (*(size_t*)block >= size))
+    return (char*)block + PF_CACHE_LINE_SIZE;
+
+  pf_aligned_free(block);
+  block = pf_aligned_alloc(PF_CACHE_LINE_SIZE + size, PF_CACHE_LINE_SIZE);
+
+  if (block == NULL)
+    return NULL;
+
+  *(size_t*)block = size;                        // the first cache line holds the block's size
+  return (char*)block + PF_CACHE_LINE_SIZE;
+}
+
+/*********************************************************************************************/
+
+void thread_pool::giveResults
+(
+  void* results                                       // returned by "takeResults()" (not NULL)
+)
+
+/*
+This function keeps a reduction's partial results memory as the pool's spare block, or frees
+it if there already is one (because another reduction ran at the same time).
+
+PRECONDITIONS:
+"results" must have been returned by "takeResults()" (and not given back since).
+
+POSTCONDITIONS:
+The memory has been kept or freed.
+*/
+
+{
+  void* const block    = (char*)results - PF_CACHE_LINE_SIZE;
+  void*       expected = NULL;
+
+  if (!pf_atomic_cas_ptr(&_spareResults, &expected, block, PF_MEMORY_ORDER_RELEASE))
+    pf_aligned_free(block);
+}
+
+// ============================================================================================
+// PRIVATE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+bool thread_pool::deque::push
+(
+  task* item                                                                // the task to push
+)
+
+/*
+This function pushes a task onto the bottom of a deque.  Only the deque's owner may call it.
+
+PRECONDITIONS:
+"item" must not be NULL.
+
+POSTCONDITIONS:
+true is returned if the task was pushed, or false if the deque was full.
+*/
+
+{
+  const int64_t bottomIndex = pf_atomic_load64(&bottom->index, PF_MEMORY_ORDER_RELAXED);
+  const int64_t start       = pf_atomic_load64(&top->index, PF_MEMORY_ORDER_ACQUIRE);
+
+  if (bottomIndex - start >= THRDPOOL_DEQUE_SIZE)
+    return false;
+
+  pf_atomic_store_ptr(&tasks[bottomIndex & (THRDPOOL_DEQUE_SIZE - 1)], item,
+                      PF_MEMORY_ORDER_RELAXED);
+  pf_atomic_store64(&bottom->index, bottomIndex + 1, PF_MEMORY_ORDER_RELEASE);
+  return true;
+}
+
+/*********************************************************************************************/
+
+thread_pool::task* thread_pool::deque::pop()
+
+/*
+This function pops the task at the bottom of a deque (the one pushed most recently).  Only the
+deque's owner may call it.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The task is returned, or NULL if the deque was empty (or a thief took the last task).
+*/
+
+{
+  const int64_t last  = pf_atomic_load64(&bottom->index, PF_MEMORY_ORDER_RELAXED) - 1;
+  int64_t       start;
+  task*         item  = NULL;
+
+  pf_atomic_store64(&bottom->index, last, PF_MEMORY_ORDER_RELAXED);
+  pf_fence_seq_cst();
+  start = pf_atomic_load64(&top->index, PF_MEMORY_ORDER_RELAXED);
+
+  if (start <= last)
+  {
+    item = (task*)pf_atomic_load_ptr(&tasks[last & (THRDPOOL_DEQUE_SIZE - 1)],
+                                     PF_MEMORY_ORDER_RELAXED);
+
+    if (start < last)
+      return item;
+
+    if (!pf_atomic_cas64(&top->index, &start, start + 1, PF_MEMORY_ORDER_SEQ_CST))
+      item = NULL;                                                      // a thief got it first
+  }
+
+  pf_atomic_store64(&bottom->index, last + 1, PF_MEMORY_ORDER_RELAXED);
+  return item;
+}
+
+/*********************************************************************************************/
+
+thread_pool::task* thread_pool::deque::steal()
+
+/*
+This function takes the task at the top of a deque (the oldest one).  Any thread may call it.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+The task is returned, or NULL if the deque was empty or another thread took the task first.
+*/
+
+{
+  int64_t start = pf_atomic_load64(&top->index, PF_MEMORY_ORDER_ACQUIRE);
+  int64_t bottomIndex;
+  task*   item;
+
+  pf_fence_seq_cst();
+  bottomIndex = pf_atomic_load64(&bottom->index, PF_MEMORY_ORDER_ACQUIRE);
+
+  if (start >= bottomIndex)
+    return NULL;
+
+  item = (task*)pf_atomic_load_ptr(&tasks[start & (THRDPOOL_DEQUE_SIZE - 1)],
+                                   PF_MEMORY_ORDER_RELAXED);
+
+  if (!pf_atomic_cas64(&top->index, &start, start + 1, PF_MEMORY_ORDER_SEQ_CST))
+    return NULL;
+
+  return item;
+}
+
+}
@@ -0,0 +1,77 @@
+// ============================================================================================
+//
+// testbyte.cpp -- Byte Order Conversion Test
+//
+// ============================================================================================
+
+/*
+This program checks that "PF_ENDIAN" agrees with the byte order that the CPU is actually using
+and that the routines in <platform/byteord.h> produce the right bytes.  It's kept apart from
+"testplat.cpp" because <platform/byteord.h> needs <stdint.h>, which older compilers don't
+have.  It prints "OK" and returns 0 if every check passes; otherwise the failed assertion is
+reported.  No other source file needs to be compiled with it.
+*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <platform.h>
+#include <platform/byteord.h>
+
+#define NUM_ARRAY_ITEMS 37                         // enough to use both SIMD and scalar code
+
+/*********************************************************************************************/
+
+int main()
+{
+  static const unsigned char bytes[8] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+
+  unsigned char stored[8];
+  uint32_t      source[NUM_ARRAY_ITEMS];
+  uint32_t      loaded[NUM_ARRAY_ITEMS];
+  unsigned char converted[NUM_ARRAY_ITEMS * sizeof(uint32_t)];
+  int           index;
+
+  assert((PF_ENDIAN == PF_ENDIAN_UNKNOWN) || (PF_ENDIAN == PF_ENDIAN_RUNTIME));
+
+  assert(pf_bswap16(0x0102U) == 0x0201U);
+  assert(pf_bswap32(0x01020304UL) == 0x04030201UL);
+  assert(pf_bswap64(0x0102030405060708ULL) == 0x0807060504030201ULL);
+
+  assert(pf_load_le16(bytes) == 0x0201U);
+  assert(pf_load_le32(bytes) == 0x04030201UL);
+  assert(pf_load_le64(bytes) == 0x0807060504030201ULL);
+  assert(pf_load_be16(bytes) == 0x0102U);
+  assert(pf_load_be32(bytes) == 0x01020304UL);
+  assert(pf_load_be64(bytes) == 0x0102030405060708ULL);
+  assert(pf_load_be32(bytes + 1) == 0x02030405UL);                   // "source" is unaligned
+
+  pf_store_le64(stored, 0x0807060504030201ULL);
+  assert(memcmp(stored, bytes, 8) == 0);
+  pf_store_be64(stored, 0x0102030405060708ULL);
+  assert(memcmp(stored, bytes, 8) == 0);
+  pf_store_be32(stored, 0x01020304UL);
+  assert(memcmp(stored, bytes, 4) == 0);
+  pf_store_le16(stored, 0x0201U);
+  assert(memcmp(stored, bytes, 2) == 0);
+
+  for (index = 0; index < NUM_ARRAY_ITEMS; index++)
+    source[index] = 0x01020304UL * (uint32_t)(index + 1);
+
+  pf_store_be32_array(converted, source, NUM_ARRAY_ITEMS);
+
+  for (index = 0; index < NUM_ARRAY_ITEMS; index++)
+    assert(pf_load_be32(converted + index * sizeof(uint32_t)) == source[index]);
+
+  pf_load_be32_array(loaded, converted, NUM_ARRAY_ITEMS);
+  assert(memcmp(loaded, source, sizeof(source)) == 0);
+
+  pf_bswap32_array(loaded, loaded, NUM_ARRAY_ITEMS);                              // in place
+
+  for (index = 0; index < NUM_ARRAY_ITEMS; index++)
+    assert(loaded[index] == pf_bswap32(source[index]));
+
+  printf("OK\n");
+  return 0;
+}
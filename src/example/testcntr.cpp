@@ -0,0 +1,92 @@
+// ============================================================================================
+//
+// testcntr.cpp -- Sharded Counter Test
+//
+// ============================================================================================
+
+/*
+This program checks that a "pf::sharded_counter" (see <platform/counter.h>) loses no additions
+when several threads add to it at once, both with the default number of shards and with fewer
+shards than threads, and that it can be reset.  It prints "OK" and returns 0 if every check
+passes; otherwise the failed assertion is reported.
+
+"src/code/counter.cpp", "src/code/affinity.cpp" and "src/code/alloc.cpp" must be compiled with
+it.
+*/
+
+#include <assert.h>
+#include <stdio.h>
+
+#include <platform.h>
+#include <platform/counter.h>
+
+#include "threads.h"
+
+#define NUM_THREADS   8
+#define NUM_ADDITIONS 100000                                           // the number per thread
+
+static pf::sharded_counter perCPU;                                         // one shard per CPU
+static pf::sharded_counter shared(3);                                 // rounded up to 4 shards
+
+static void addToCounters(unsigned);
+
+/*********************************************************************************************/
+
+int main()
+{
+  const int64_t expected = (int64_t)NUM_THREADS * NUM_ADDITIONS;
+
+  int round;
+
+  assert(shared.shards() == 4);
+  assert((perCPU.shards() & (perCPU.shards() - 1)) == 0);                       // a power of 2
+  assert(perCPU.value() == 0);
+
+  for (round = 0; round < 2; round++)
+  {
+    runThreads(NUM_THREADS, &addToCounters);
+
+    assert(perCPU.value() == expected);
+    assert(shared.value() == expected / 2);
+
+    perCPU.reset();
+    shared.reset();
+    assert((perCPU.value() == 0) && (shared.value() == 0));
+  }
+
+  shared.add(-5);                                                     // shards can go negative
+  assert(shared.value() == -5);
+
+  printf("OK\n");
+  return 0;
+}
+
+/*********************************************************************************************/
+
+static void addToCounters
+(
+  unsigned thread                                                        // the thread's number
+)
+
+/*
+This function adds 1 to "perCPU" "NUM_ADDITIONS" times and adds 3 and takes away 2 from
+"shared" alternately, the same number of times.
+
+PRECONDITIONS:
+"NUM_ADDITIONS" must be even.
+
+POSTCONDITIONS:
+"perCPU" has been increased by "NUM_ADDITIONS" and "shared" by "NUM_ADDITIONS" / 2.
+*/
+
+{
+  long count;
+
+  (void)thread;
+
+  for (count = 0; count < NUM_ADDITIONS; count++)
+  {
+    perCPU.add();
+    shared.add((count % 2 == 0) ? 3 : -2);
+  }
+}
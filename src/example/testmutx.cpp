@@ -0,0 +1,123 @@
+// ============================================================================================
+//
+// testmutx.cpp -- Adaptive Mutex Test
+//
+// ============================================================================================
+
+/*
+This program checks the routines in <platform/mutex.h>:  that a "pf::adaptive_mutex" lets only
+one thread at a time into a critical section, so that no increment of an ordinary counter is
+lost, and that a thread waiting with "pf_wait_on_address()" sees the change that woke it.  It
+prints "OK" and returns 0 if every check passes; otherwise the failed assertion is reported.
+
+"src/code/mutex.cpp" must be compiled with it.
+*/
+
+#include <assert.h>
+#include <stdio.h>
+
+#include <platform.h>
+#include <platform/atomic.h>
+#include <platform/mutex.h>
+
+#include "threads.h"
+
+#define NUM_THREADS    4
+#define NUM_INCREMENTS 100000                                          // the number per thread
+
+static pf::adaptive_mutex counterLock;
+static long               counter;                                // protected by "counterLock"
+static int                inside;                       // whether a thread holds "counterLock"
+static pf_atomic32_t      awoken;                              // set to 1 by the waking thread
+
+static void addToCounter(unsigned);
+static void waitForSignal(unsigned);
+
+/*********************************************************************************************/
+
+int main()
+{
+  assert(counterLock.try_lock());
+  assert(!counterLock.try_lock());
+  counterLock.unlock();
+
+  runThreads(NUM_THREADS, &addToCounter);
+  assert(counter == (long)NUM_THREADS * NUM_INCREMENTS);
+  assert(counterLock.try_lock());
+  counterLock.unlock();
+
+  pf_wait_on_address(&awoken, 1);                  // "awoken" isn't 1, so this returns at once
+
+  #if (PF_THREADS_API != PF_THREADS_NONE)
+    runThreads(2, &waitForSignal);
+  #endif
+
+  printf("OK\n");
+  return 0;
+}
+
+/*********************************************************************************************/
+
+static void addToCounter
+(
+  unsigned thread                                                        // the thread's number
+)
+
+/*
+This function increments "counter" "NUM_INCREMENTS" times, locking "counterLock" around each
+increment (or every other one with "try_lock()", when it succeeds).
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+"counter" has been increased by "NUM_INCREMENTS".
+*/
+
+{
+  long count;
+
+  for (count = 0; count < NUM_INCREMENTS; count++)
+  {
+    if ((count + thread) % 2 == 0 || !counterLock.try_lock())
+      counterLock.lock();
+
+    assert(!inside);
+    inside = 1;
+    counter++;
+    inside = 0;
+
+    counterLock.unlock();
+  }
+}
+
+/*********************************************************************************************/
+
+static void waitForSignal
+(
+  unsigned thread                                         // 0 waits, 1 sets "awoken" and wakes
+)
+
+/*
+This function either waits until "awoken" is 1 or sets it to 1 and wakes the waiting thread.
+
+PRECONDITIONS:
+It must be called on two threads at once, one with each value of "thread".
+
+POSTCONDITIONS:
+"awoken" is 1.
+*/
+
+{
+  if (thread == 0)
+  {
+    while (pf_atomic_load32(&awoken, PF_MEMORY_ORDER_ACQUIRE) != 1)
+      pf_wait_on_address(&awoken, 0);
+  }
+  else
+  {
+    yieldThread();                                       // give the other thread time to sleep
+    pf_atomic_store32(&awoken, 1, PF_MEMORY_ORDER_RELEASE);
+    pf_wake_by_address_all(&awoken);
+  }
+}
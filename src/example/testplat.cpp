@@ -8,7 +8,8 @@
 
 #include <platform.h>
 
-#define NUM_ENDIAN_TYPES 3
+#define NUM_ENDIAN_TYPES      3
+#define NUM_THREADS_API_TYPES 4
 
 typedef struct
 {
@@ -55,7 +56,12 @@ int main()
                         {PF_INTEL_X86,      "Intel x86 or compatible"},
                         {PF_MIPS,           "MIPS"},
                         {PF_MOTOROLA_68X00, "Motorola 68x00 series"},
-                        {PF_NS_32000,       "National Semiconductor 32000"}
+                        {PF_NS_32000,       "National Semiconductor 32000"},
+                        {PF_AMD_X86_64,     "x86-64 (AMD64 or Intel 64)"},
+                        {PF_ARM_AARCH32,    "ARM (32-bit)"},
+                        {PF_ARM_AARCH64,    "ARM AArch64"},
+                        {PF_IBM_POWERPC64,  "IBM PowerPC (64-bit)"},
+                        {PF_RISC_V,         "RISC-V"}
                       };
 
   const ValueTextPair endians[NUM_ENDIAN_TYPES] =
@@ -65,6 +71,14 @@ int main()
                         {PF_ENDIAN_BIG,     "Big (most "}
                       };
 
+  const ValueTextPair threadsApis[NUM_THREADS_API_TYPES] =
+                      {
+                        {PF_THREADS_NONE,  "None"},
+                        {PF_THREADS_POSIX, "POSIX threads"},
+                        {PF_THREADS_WIN32, "Win32 threads"},
+                        {PF_THREADS_CPP11, "C++11 threads"}
+                      };
+
   cout << "Compiler:          " << lookup(compilers, PF_NUMCOMPILERTYPES, PF_COMPILER) << endl;
   cout << "Compiler version:  " << hex << PF_COMPILER_VER << dec << endl;
   cout << "OS API:            " << lookup(osApis, PF_NUMOSTYPES, PF_OS) << endl;
@@ -72,6 +86,8 @@ int main()
   cout << "CPU endian:        " << lookup(endians, NUM_ENDIAN_TYPES, PF_ENDIAN) <<
                                      "significant bytes come first)" << endl;
   cout << "Multithreaded:     " << (PF_MULTITHREADED ? "Yes" : "No") << endl;
+  cout << "Threads API:       " <<
+          lookup(threadsApis, NUM_THREADS_API_TYPES, PF_THREADS_API) << endl;
 
   cout << endl;
 
@@ -0,0 +1,128 @@
+// ============================================================================================
+//
+// testpool.cpp -- Arena and Pool Allocator Test
+//
+// ============================================================================================
+
+/*
+This program checks that a "pf::arena" (see <platform/arena.h>) returns aligned,
+non-overlapping blocks and can be reset and reused, and that a "pf::pool" (see
+<platform/pool.h>) never hands the same block to two threads at once.  It prints "OK" and
+returns 0 if every check passes; otherwise the failed assertion is reported.
+
+"src/code/arena.cpp", "src/code/pool.cpp" and "src/code/alloc.cpp" must be compiled with it.
+*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <platform.h>
+#include <platform/arena.h>
+#include <platform/pool.h>
+
+#include "threads.h"
+
+#define NUM_BLOCKS  1000                                // the number of arena blocks per round
+#define NUM_THREADS 4
+#define NUM_ROUNDS  200                             // the number of times each thread fills up
+#define NUM_OBJECTS 500                                      // objects held at once per thread
+
+struct Record
+{
+  unsigned owner;                                                   // the thread that holds it
+  unsigned serial;                                      // which of that thread's objects it is
+
+  Record(): owner(NUM_THREADS), serial(0) {}
+};
+
+static pf::pool<Record> records;
+
+static void useRecords(unsigned);
+
+/*********************************************************************************************/
+
+int main()
+{
+  pf::arena scratch(4096);
+  char*     blocks[NUM_BLOCKS];
+  size_t    sizes[NUM_BLOCKS];
+  int       round;
+  int       index;
+
+  for (round = 0; round < 3; round++)
+  {
+    for (index = 0; index < NUM_BLOCKS; index++)
+    {
+      const size_t alignment = (size_t)1 << (index % 7);
+
+      sizes[index]  = (size_t)(index % 100) + 1;
+      blocks[index] = (char*)scratch.allocate(sizes[index], alignment);
+
+      assert(blocks[index] != NULL);
+      assert(((size_t)blocks[index] & (alignment - 1)) == 0);
+      memset(blocks[index], index & 0xFF, sizes[index]);
+    }
+
+    for (index = 0; index < NUM_BLOCKS; index++)                     // nothing was overwritten
+    {
+      assert((unsigned char)blocks[index][0] == (index & 0xFF));
+      assert((unsigned char)blocks[index][sizes[index] - 1] == (index & 0xFF));
+    }
+
+    assert(scratch.allocate(100000) != NULL);                            // bigger than a chunk
+    scratch.reset();
+  }
+
+  scratch.release();
+  assert(scratch.reserved() == 0);
+
+  assert(records.block_size() >= sizeof(Record));
+  runThreads(NUM_THREADS, &useRecords);
+
+  printf("OK\n");
+  return 0;
+}
+
+/*********************************************************************************************/
+
+static void useRecords
+(
+  unsigned thread                                                        // the thread's number
+)
+
+/*
+This function repeatedly creates a batch of records, marks each one as its own, checks that no
+other thread has changed them and destroys them.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+None.
+*/
+
+{
+  Record*  held[NUM_OBJECTS];
+  int      round;
+  unsigned index;
+
+  for (round = 0; round < NUM_ROUNDS; round++)
+  {
+    for (index = 0; index < NUM_OBJECTS; index++)
+    {
+      held[index] = records.create();
+      assert(held[index] != NULL);
+      assert(held[index]->owner == NUM_THREADS);                         // freshly constructed
+
+      held[index]->owner  = thread;
+      held[index]->serial = index;
+    }
+
+    for (index = 0; index < NUM_OBJECTS; index++)
+    {
+      assert((held[index]->owner == thread) && (held[index]->serial == index));
+      records.destroy(held[index]);
+    }
+  }
+}
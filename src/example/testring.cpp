@@ -0,0 +1,224 @@
+// ============================================================================================
+//
+// testring.cpp -- Ring Buffer Test
+//
+// ============================================================================================
+
+/*
+This program checks the ring buffers in <platform/ring.h>:  that they hold exactly their
+capacity, that a "pf::spsc_ring" delivers every item in order from one thread to another, and
+that a "pf::mpmc_ring" delivers every item exactly once when several threads push and pop at
+once.  It prints "OK" and returns 0 if every check passes; otherwise the failed assertion is
+reported.  No other source file needs to be compiled with it.
+*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <platform.h>
+#include <platform/ring.h>
+
+#include "threads.h"
+
+#define NUM_ITEMS     200000                                // the number of items per producer
+#define NUM_PRODUCERS 4                   // the number of "shared" producers, and of consumers
+#define BATCH_SIZE    7                              // the most items pushed or popped at once
+
+static pf::spsc_ring<long> single(1000);
+static pf::mpmc_ring<long> shared(64);
+static long                sums[NUM_PRODUCERS];                    // what each consumer popped
+static unsigned char       seen[NUM_ITEMS * NUM_PRODUCERS];   // how often each item was popped
+
+template <class Ring> static void pushAll(Ring&, long, long);
+static void useSingle(unsigned);
+static void useShared(unsigned);
+
+/*********************************************************************************************/
+
+int main()
+{
+  pf::spsc_ring<int> tiny(0);
+  pf::mpmc_ring<int> small(5);
+  int                items[8];
+  int                item;
+  int                index;
+  long               expected;
+
+  assert(tiny.capacity() == 2);
+  assert(small.capacity() == 8);
+  assert(single.capacity() == 1024);
+
+  for (index = 0; index < 8; index++)
+    items[index] = index;
+
+  assert(small.push_batch(items, 5) == 5);
+  assert(small.push_batch(items + 5, 8) == 3);                                    // only 3 fit
+  assert(!small.try_push(8));
+  assert(small.pop_batch(items, 4) == 4);                                    // now wrap around
+  assert(small.push_batch(items, 4) == 4);
+
+  for (index = 4; index < 12; index++)
+  {
+    assert(small.try_pop(item));
+    assert(item == index % 8);
+  }
+
+  assert(!small.try_pop(item));
+
+  #if (PF_THREADS_API != PF_THREADS_NONE)
+
+    runThreads(2, &useSingle);
+    runThreads(2 * NUM_PRODUCERS, &useShared);
+
+    expected = 0;
+
+    for (index = 0; index < NUM_ITEMS * NUM_PRODUCERS; index++)
+    {
+      assert(seen[index] == 1);
+      expected += index;
+    }
+
+    for (index = 0; index < NUM_PRODUCERS; index++)
+      expected -= sums[index];
+
+    assert(expected == 0);
+
+  #else
+
+    (void)expected;
+
+  #endif
+
+  printf("OK\n");
+  return 0;
+}
+
+/*********************************************************************************************/
+
+template <class Ring> static void pushAll
+(
+  Ring& ring,                                                            // the ring to push to
+  long  first,                                                                // the first item
+  long  end                                                      // the item after the last one
+)
+
+/*
+This function pushes a run of consecutive numbers, in batches, waiting for room when the ring
+is full.  "Ring" is either kind of ring of "long"s.
+
+PRECONDITIONS:
+"first" must be no greater than "end".
+
+POSTCONDITIONS:
+"first" to "end" - 1 have been pushed in order.
+*/
+
+{
+  long   batch[BATCH_SIZE];
+  size_t count;
+  size_t done;
+
+  while (first < end)
+  {
+    for (count = 0; (count < BATCH_SIZE) && (first + (long)count < end); count++)
+      batch[count] = first + (long)count;
+
+    for (done = 0; done < count; done += ring.push_batch(batch + done, count - done))
+      yieldThread();
+
+    first += (long)count;
+  }
+}
+
+/*********************************************************************************************/
+
+static void useSingle
+(
+  unsigned thread                                     // 0 for the producer, 1 for the consumer
+)
+
+/*
+This function either pushes "NUM_ITEMS" numbers to "single" or pops them and checks that they
+arrive in order.
+
+PRECONDITIONS:
+It must be called on two threads at once, one with each value of "thread".
+
+POSTCONDITIONS:
+None.
+*/
+
+{
+  long expected;
+  long item;
+
+  if (thread == 0)
+    pushAll(single, 0, NUM_ITEMS);
+  else
+  {
+    for (expected = 0; expected < NUM_ITEMS; )
+    {
+      if (single.try_pop(item))
+      {
+        assert(item == expected);
+        expected++;
+      }
+      else
+        yieldThread();
+    }
+
+    assert(!single.try_pop(item));
+  }
+}
+
+/*********************************************************************************************/
+
+static void useShared
+(
+  unsigned thread                                         // even numbers push, odd numbers pop
+)
+
+/*
+This function either pushes "NUM_ITEMS" numbers (different ones for each producer) to "shared"
+or pops "NUM_ITEMS" numbers from it, adds them up and counts how often each one was popped.
+
+PRECONDITIONS:
+It must be called on "NUM_PRODUCERS" * 2 threads at once, one with each value of "thread".
+
+POSTCONDITIONS:
+Once all the threads have returned, "sums" holds the totals and "seen" holds the counts.
+*/
+
+{
+  const long first = (long)(thread / 2) * NUM_ITEMS;
+
+  long   batch[BATCH_SIZE];
+  long   left;
+  long   sum;
+  size_t count;
+  size_t index;
+
+  if (thread % 2 == 0)
+    pushAll(shared, first, first + NUM_ITEMS);
+  else
+  {
+    sum = 0;
+
+    for (left = NUM_ITEMS; left > 0; left -= (long)count)
+    {
+      count = shared.pop_batch(batch, (left < BATCH_SIZE) ? (size_t)left : BATCH_SIZE);
+
+      for (index = 0; index < count; index++)
+      {
+        sum += batch[index];
+        seen[batch[index]]++;
+      }
+
+      if (count == 0)
+        yieldThread();
+    }
+
+    sums[thread / 2] = sum;
+  }
+}
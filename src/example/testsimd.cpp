@@ -0,0 +1,261 @@
+// ============================================================================================
+//
+// testsimd.cpp -- Portable SIMD Vector Test
+//
+// ============================================================================================
+
+/*
+This program checks every operation on the vectors in <platform/simd.h> against the same
+operation done one lane at a time, for "pf::vec<float, N>" and "pf::vec<int32_t, N>" with 4, 8
+and 16 lanes.  Which of them are held in SIMD registers depends on the compiler's options, so
+it should be compiled several times (with "-msse4.1", "-mavx" and "-mavx2" as well as without,
+for example) to check each set of specializations.  It prints "OK" and returns 0 if every check
+passes; otherwise the failed assertion is reported.  No other source file needs to be compiled
+with it.
+*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <platform.h>
+#include <platform/simd.h>
+
+#define MAX_LANES 16
+
+template <class T, int N> static void checkVectors(void);
+template <int N> static void checkTypeSpecific(const float*, const float*);
+template <int N> static void checkTypeSpecific(const int32_t*, const int32_t*);
+
+/*********************************************************************************************/
+
+int main()
+{
+  checkVectors<float, 4>();
+  checkVectors<float, 8>();
+  checkVectors<float, 16>();
+  checkVectors<int32_t, 4>();
+  checkVectors<int32_t, 8>();
+  checkVectors<int32_t, 16>();
+
+  assert(pf::native_lanes<float>::value >= 1);
+  assert(pf::native_lanes<int32_t>::value >= 1);
+
+  printf("OK\n");
+  return 0;
+}
+
+/*********************************************************************************************/
+
+template <class T, int N> static void checkVectors(void)
+
+/*
+This function checks the operations that every vector has, using small whole numbers so that
+floating-point results are exact.
+
+PRECONDITIONS:
+"N" must be a multiple of 4 and no greater than "MAX_LANES".
+
+POSTCONDITIONS:
+None.
+*/
+
+{
+  typedef pf::vec<T, N>  vector;
+  typedef pf::mask<T, N> mask;
+
+  PF_ALIGNAS(64) T aligned[MAX_LANES];
+  T                a[MAX_LANES + 1];                                 // one extra for "loadu()"
+  T                b[MAX_LANES];
+  T                stored[MAX_LANES + 1];
+  vector           va;
+  vector           vb;
+  vector           result;
+  mask             lessThan;
+  T                sum;
+  T                least;
+  T                greatest;
+  int              i;
+
+  for (i = 0; i < MAX_LANES + 1; i++)
+    a[i] = (T)((i * 7) % 11) - (T)5;
+
+  for (i = 0; i < MAX_LANES; i++)
+  {
+    b[i]       = (T)((i * 5) % 9) - (T)4;
+    aligned[i] = b[i];
+  }
+
+  va = vector::loadu(a + 1);                                            // unaligned on purpose
+  vb = vector::load(aligned);
+
+  for (i = 0; i < N; i++)
+    assert((va[i] == a[i + 1]) && (vb[i] == b[i]));
+
+  va.storeu(stored + 1);
+  assert(memcmp(stored + 1, a + 1, N * sizeof(T)) == 0);
+  vb.store(aligned);
+  assert(memcmp(aligned, b, N * sizeof(T)) == 0);
+
+  va = vector::loadu(a);
+  assert(vector((T)3)[N - 1] == (T)3);
+
+  // Arithmetic
+
+  result = va + vb;
+
+  for (i = 0; i < N; i++)
+    assert(result[i] == a[i] + b[i]);
+
+  result = va - vb;
+
+  for (i = 0; i < N; i++)
+    assert(result[i] == a[i] - b[i]);
+
+  result = va * vb;
+
+  for (i = 0; i < N; i++)
+    assert(result[i] == a[i] * b[i]);
+
+  result  = va;
+  result += vb;
+  result *= vb;
+  result -= va;
+
+  for (i = 0; i < N; i++)
+    assert(result[i] == (a[i] + b[i]) * b[i] - a[i]);
+
+  // Comparisons, masks and blending
+
+  lessThan = va < vb;
+
+  for (i = 0; i < N; i++)
+  {
+    assert(lessThan[i] == (a[i] < b[i]));
+    assert((va <= vb)[i] == (a[i] <= b[i]));
+    assert((va > vb)[i] == (a[i] > b[i]));
+    assert((va >= vb)[i] == (a[i] >= b[i]));
+    assert((va == vb)[i] == (a[i] == b[i]));
+    assert((va != vb)[i] == (a[i] != b[i]));
+    assert((~lessThan)[i] == !(a[i] < b[i]));
+    assert((lessThan & (va > vector((T)0)))[i] == ((a[i] < b[i]) && (a[i] > 0)));
+    assert((lessThan | (va > vector((T)0)))[i] == ((a[i] < b[i]) || (a[i] > 0)));
+  }
+
+  assert(pf::all(va == va) && !pf::any(va != va));
+  assert(pf::any(lessThan) && !pf::all(lessThan));
+
+  result = pf::blend(lessThan, va, vb);
+
+  for (i = 0; i < N; i++)
+    assert(result[i] == ((a[i] < b[i]) ? a[i] : b[i]));
+
+  result = pf::min(va, vb);
+
+  for (i = 0; i < N; i++)
+    assert(result[i] == ((b[i] < a[i]) ? b[i] : a[i]));
+
+  result = pf::max(va, vb);
+
+  for (i = 0; i < N; i++)
+    assert(result[i] == ((b[i] > a[i]) ? b[i] : a[i]));
+
+  // Shuffles (within each group of four lanes)
+
+  result = pf::shuffle<2, 0, 3, 1>(va);
+
+  for (i = 0; i < N; i += 4)
+  {
+    assert((result[i] == a[i + 2]) && (result[i + 1] == a[i]));
+    assert((result[i + 2] == a[i + 3]) && (result[i + 3] == a[i + 1]));
+  }
+
+  result = pf::shuffle<3, 3, 0, 0>(va);
+
+  for (i = 0; i < N; i += 4)
+  {
+    assert((result[i] == a[i + 3]) && (result[i + 1] == a[i + 3]));
+    assert((result[i + 2] == a[i]) && (result[i + 3] == a[i]));
+  }
+
+  // Horizontal reductions
+
+  sum      = 0;
+  least    = a[0];
+  greatest = a[0];
+
+  for (i = 0; i < N; i++)
+  {
+    sum     += a[i];
+    least    = (a[i] < least) ? a[i] : least;
+    greatest = (a[i] > greatest) ? a[i] : greatest;
+  }
+
+  assert(pf::reduce_add(va) == sum);
+  assert(pf::reduce_min(va) == least);
+  assert(pf::reduce_max(va) == greatest);
+
+  checkTypeSpecific<N>(a, b);
+}
+
+/*********************************************************************************************/
+
+template <int N> static void checkTypeSpecific
+(
+  const float* a,                                                         // the first operands
+  const float* b                                                         // the second operands
+)
+
+/*
+This function checks division, which only "float" vectors have.
+
+PRECONDITIONS:
+"a" and "b" must each hold "N" values, all of them whole numbers.
+
+POSTCONDITIONS:
+None.
+*/
+
+{
+  const pf::vec<float, N> half(0.5f);
+
+  pf::vec<float, N> result = pf::vec<float, N>::loadu(a);
+  int               i;
+
+  result /= pf::vec<float, N>::loadu(b) + half;                        // never divides by zero
+
+  for (i = 0; i < N; i++)
+    assert(result[i] == a[i] / (b[i] + 0.5f));
+}
+
+/*********************************************************************************************/
+
+template <int N> static void checkTypeSpecific
+(
+  const int32_t* a,                                                       // the first operands
+  const int32_t* b                                                       // the second operands
+)
+
+/*
+This function checks the bitwise operations, which only "int32_t" vectors have.
+
+PRECONDITIONS:
+"a" and "b" must each hold "N" values.
+
+POSTCONDITIONS:
+None.
+*/
+
+{
+  const pf::vec<int32_t, N> va = pf::vec<int32_t, N>::loadu(a);
+  const pf::vec<int32_t, N> vb = pf::vec<int32_t, N>::loadu(b);
+
+  int i;
+
+  for (i = 0; i < N; i++)
+  {
+    assert((va & vb)[i] == (a[i] & b[i]));
+    assert((va | vb)[i] == (a[i] | b[i]));
+    assert((va ^ vb)[i] == (a[i] ^ b[i]));
+  }
+}
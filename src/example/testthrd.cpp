@@ -0,0 +1,147 @@
+// ============================================================================================
+//
+// testthrd.cpp -- Thread Pool Test
+//
+// ============================================================================================
+
+/*
+This program checks that a "pf::thread_pool" (see <platform/thrdpool.h>) calls a
+"parallel_for()" body exactly once for every item, in subranges no longer than the grain size,
+that "parallel_reduce()" returns the right total, and that a body can run loops of its own on
+the same pool, even after running one on another pool.  It prints "OK" and returns 0 if every
+check passes; otherwise the failed assertion is reported.
+
+"src/code/thrdpool.cpp", "src/code/mutex.cpp", "src/code/pool.cpp", "src/code/alloc.cpp" and
+"src/code/affinity.cpp" must be compiled with it.
+*/
+
+#include <assert.h>
+#include <stdio.h>
+
+#include <platform.h>
+#include <platform/thrdpool.h>
+
+#define NUM_ITEMS  1000003                                  // not a multiple of any grain size
+#define NUM_ROUNDS 20
+#define NUM_OUTER  64                                      // the number of loops within a loop
+#define NUM_INNER  1000                                        // the length of each inner loop
+
+static long                      items[NUM_ITEMS];
+static int64_t                   totals[NUM_OUTER];
+static const int64_t             zero = 0;                            // the identity for "Add"
+static pf::thread_pool*          workers;                      // the pool that "RunInner" uses
+static pf::thread_pool*          others;                // the other pool that "RunAcross" uses
+
+struct AddIndex                                           // adds each item's index to the item
+{
+  size_t grain;
+
+  void operator()(size_t first, const size_t last) const
+  {
+    assert((first < last) && (last - first <= grain));
+
+    for (; first < last; first++)
+      items[first] += (long)first;
+  }
+};
+
+struct SumItems                                                           // adds up some items
+{
+  int64_t operator()(size_t first, const size_t last) const
+  {
+    int64_t sum = 0;
+
+    for (; first < last; first++)
+      sum += items[first];
+
+    return sum;
+  }
+};
+
+struct CountItems                                                          // counts some items
+{
+  int64_t operator()(const size_t first, const size_t last) const
+  {
+    return (int64_t)(last - first);
+  }
+};
+
+struct Add
+{
+  int64_t operator()(const int64_t a, const int64_t b) const {return a + b;}
+};
+
+struct RunInner                                       // sets each total with a loop of its own
+{
+  void operator()(size_t first, const size_t last) const
+  {
+    for (; first < last; first++)
+      totals[first] = workers->parallel_reduce(0, NUM_INNER, 37, zero, CountItems(), Add());
+  }
+};
+
+struct RunAcross                           // runs a loop on another pool, then on its own pool
+{
+  void operator()(size_t first, const size_t last) const
+  {
+    for (; first < last; first++)
+    {
+      totals[first] = others->parallel_reduce(0, NUM_INNER, 37, zero, CountItems(), Add());
+      totals[first] += workers->parallel_reduce(0, NUM_INNER, 37, zero, CountItems(), Add());
+    }
+  }
+};
+
+/*********************************************************************************************/
+
+int main()
+{
+  pf::thread_pool pool(4);
+  pf::thread_pool single(1);
+  pf::thread_pool other(2);
+  AddIndex        addIndex;
+  long            index;
+  int             round;
+
+  assert(pool.size() == 4);
+  assert(single.size() == 1);
+
+  for (round = 0; round < NUM_ROUNDS; round++)
+  {
+    addIndex.grain = (size_t)(round * 97 + 1);
+    pool.parallel_for(0, NUM_ITEMS, addIndex.grain, addIndex);
+  }
+
+  for (index = 0; index < NUM_ITEMS; index++)
+    assert(items[index] == index * NUM_ROUNDS);
+
+  assert(pool.parallel_reduce(0, NUM_ITEMS, 777, zero, SumItems(), Add()) ==
+         (int64_t)NUM_ROUNDS * (NUM_ITEMS - 1) * NUM_ITEMS / 2);
+  assert(pool.parallel_reduce(0, NUM_ITEMS, 777, zero, CountItems(), Add()) == NUM_ITEMS);
+  assert(pool.parallel_reduce(10, 10, 777, zero, CountItems(), Add()) == 0);        // no items
+  pool.parallel_for(10, 10, 1, addIndex);
+
+  addIndex.grain = 3;
+  single.parallel_for(0, 10, addIndex.grain, addIndex);
+  assert(items[9] == 9 * (NUM_ROUNDS + 1));
+  assert(single.parallel_reduce(0, NUM_ITEMS, 999, zero, CountItems(), Add()) == NUM_ITEMS);
+
+  #ifdef PF_THREAD_LOCAL
+
+    workers = &pool;
+    pool.parallel_for(0, NUM_OUTER, 1, RunInner());
+
+    for (index = 0; index < NUM_OUTER; index++)
+      assert(totals[index] == NUM_INNER);
+
+    others = &other;
+    pool.parallel_for(0, NUM_OUTER, 1, RunAcross());
+
+    for (index = 0; index < NUM_OUTER; index++)
+      assert(totals[index] == 2 * NUM_INNER);
+
+  #endif
+
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,187 @@
+#ifndef EXAMPLE_THREADS_H
+#define EXAMPLE_THREADS_H
+
+// ============================================================================================
+//
+// threads.h -- Thread Helpers for the Test Programs
+//
+// ============================================================================================
+
+/*
+This header file defines the two things that the multithreaded test programs need from the
+operating system's threads API (see "PF_THREADS_API" in <platform.h>):
+
+  void runThreads(unsigned count, void (*routine)(unsigned index))
+  void yieldThread(void)
+
+"runThreads()" calls "routine(0)" to "routine(count - 1)" on "count" threads at once (at most
+"MAX_TEST_THREADS") and returns when they've all returned.  "yieldThread()" gives the CPU to
+another thread, so that a test that spins waiting for another thread makes progress on a
+computer with only one CPU.  If "PF_THREADS_API" is "PF_THREADS_NONE" then "runThreads()"
+calls the routines one after another, so a test whose threads wait for each other must check
+"PF_THREADS_API" first.
+
+NOTE:  This header file requires a C++ compiler.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <platform.h>
+
+#if (PF_THREADS_API == PF_THREADS_POSIX)
+  #include <pthread.h>
+  #include <sched.h>
+#elif (PF_THREADS_API == PF_THREADS_WIN32)
+  #include <windows.h>
+  #include <process.h>
+#elif (PF_THREADS_API == PF_THREADS_CPP11)
+  #include <thread>
+#endif
+
+// ============================================================================================
+// MACRO DEFINITIONS
+// ============================================================================================
+
+// The largest number of threads that "runThreads()" can start
+
+#define MAX_TEST_THREADS 16
+
+// ============================================================================================
+// TYPE DEFINITIONS
+// ============================================================================================
+
+typedef struct
+{
+  void     (*routine)(unsigned);                                                // what to call
+  unsigned index;                                                        // the thread's number
+}
+TestThread;
+
+// ============================================================================================
+// INLINE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+#if (PF_THREADS_API == PF_THREADS_POSIX)
+
+  inline void* startTestThread(void* thread)
+  {
+    ((TestThread*)thread)->routine(((TestThread*)thread)->index);
+    return NULL;
+  }
+
+#elif (PF_THREADS_API == PF_THREADS_WIN32)
+
+  inline unsigned __stdcall startTestThread(void* thread)
+  {
+    ((TestThread*)thread)->routine(((TestThread*)thread)->index);
+    return 0;
+  }
+
+#endif
+
+/*********************************************************************************************/
+
+inline void runThreads
+(
+  const unsigned count,                                         // the number of threads to run
+  void           (*routine)(unsigned)                       // called with each thread's number
+)
+
+/*
+This function runs a routine on several threads at once and waits for them all to finish.
+
+PRECONDITIONS:
+"count" must be no greater than "MAX_TEST_THREADS".
+
+POSTCONDITIONS:
+"routine()" has been called (and has returned) once for each number from 0 to "count" - 1.  If
+a thread can't be started then a message is printed and the program exits.
+*/
+
+{
+  TestThread threads[MAX_TEST_THREADS];
+  unsigned   index;
+
+  for (index = 0; index < count; index++)
+  {
+    threads[index].routine = routine;
+    threads[index].index   = index;
+  }
+
+  #if (PF_THREADS_API == PF_THREADS_POSIX)
+
+    pthread_t handles[MAX_TEST_THREADS];
+
+    for (index = 0; index < count; index++)
+    {
+      if (pthread_create(&handles[index], NULL, &startTestThread, &threads[index]) != 0)
+      {
+        printf("Can't start thread %u.\n", index);
+        exit(1);
+      }
+    }
+
+    for (index = 0; index < count; index++)
+      pthread_join(handles[index], NULL);
+
+  #elif (PF_THREADS_API == PF_THREADS_WIN32)
+
+    HANDLE handles[MAX_TEST_THREADS];
+
+    for (index = 0; index < count; index++)
+    {
+      handles[index] = (HANDLE)_beginthreadex(NULL, 0, &startTestThread, &threads[index], 0,
+                                              NULL);
+
+      if (handles[index] == NULL)
+      {
+        printf("Can't start thread %u.\n", index);
+        exit(1);
+      }
+    }
+
+    for (index = 0; index < count; index++)
+    {
+      WaitForSingleObject(handles[index], INFINITE);
+      CloseHandle(handles[index]);
+    }
+
+  #elif (PF_THREADS_API == PF_THREADS_CPP11)
+
+    std::thread handles[MAX_TEST_THREADS];
+
+    for (index = 0; index < count; index++)
+      handles[index] = std::thread(routine, index);
+
+    for (index = 0; index < count; index++)
+      handles[index].join();
+
+  #else
+
+    for (index = 0; index < count; index++)
+      routine(index);
+
+  #endif
+}
+
+/*********************************************************************************************/
+
+inline void yieldThread(void)
+{
+  #if (PF_THREADS_API == PF_THREADS_POSIX)
+    sched_yield();
+  #elif (PF_THREADS_API == PF_THREADS_WIN32)
+    SwitchToThread();
+  #elif (PF_THREADS_API == PF_THREADS_CPP11)
+    std::this_thread::yield();
+  #endif
+}
+
+#endif
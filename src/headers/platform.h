@@ -77,6 +77,18 @@ it would be possible to code:
 DANGER!!!  Not all compilers perform macro replacement before processing #pragma directives,
 which means that pragma macros have no effect on these compilers.
 
+Where the compiler supports "PF_PRAGMA()" (see below), each pragma directive macro also has a
+"PF_PRAGMA_..." counterpart that expands to the whole directive rather than to the text that
+follows "#pragma", so it works on those compilers too and can be used inside other macros.
+(Watcom C/C++ has no operator of its own for this, so it only has them when compiling C99,
+through the standard "_Pragma()".)  For example:
+
+  #define PACKED_STRUCT(name, members)                                                  \
+    PF_PRAGMA_PACKING_PUSH PF_PRAGMA_PACKING_SET(1) struct name members;                \
+    PF_PRAGMA_PACKING_POP
+
+  PACKED_STRUCT(Header, {uint8_t type; uint32_t length;})
+
 This header file can be included multiple times.  This will allow the standard header file
 detection macros to be updated.  Suppose the following header files are included (in this
 example, assume that this is what the preprocessor sees):
@@ -128,16 +140,21 @@ Note that ANSI C/C++ allows macros to be redeclared provided that they're identi
   CPU type macros:
   */
 
-  #define PF_UNKNOWN_CPU    0
-  #define PF_AMD_29000      1
-  #define PF_DEC_ALPHA      2
-  #define PF_DEC_VAX        3
-  #define PF_IBM_POWERPC    4
-  #define PF_INTEL_X86      5
-  #define PF_MIPS           6
-  #define PF_MOTOROLA_68X00 7
-  #define PF_NS_32000       8
-  #define PF_NUMCPUTYPES    9
+  #define PF_UNKNOWN_CPU     0
+  #define PF_AMD_29000       1
+  #define PF_DEC_ALPHA       2
+  #define PF_DEC_VAX         3
+  #define PF_IBM_POWERPC     4
+  #define PF_INTEL_X86       5
+  #define PF_MIPS            6
+  #define PF_MOTOROLA_68X00  7
+  #define PF_NS_32000        8
+  #define PF_AMD_X86_64      9
+  #define PF_ARM_AARCH32    10
+  #define PF_ARM_AARCH64    11
+  #define PF_IBM_POWERPC64  12
+  #define PF_RISC_V         13
+  #define PF_NUMCPUTYPES    14
 
   /*
   Endian type macros
@@ -147,6 +164,15 @@ Note that ANSI C/C++ allows macros to be redeclared provided that they're identi
   #define PF_ENDIAN_BIG     1
   #define PF_ENDIAN_LITTLE  2
 
+  /*
+  Threads API type macros
+  */
+
+  #define PF_THREADS_NONE  0
+  #define PF_THREADS_POSIX 1
+  #define PF_THREADS_WIN32 2
+  #define PF_THREADS_CPP11 3
+
 #endif
 
 // ============================================================================================
@@ -182,10 +208,198 @@ routines.  For example, a comparison function for "qsort()" might be declared as
 
   static PF_STD_LIB_CALL int compareRecords(const void*, const void*);
 
+"PF_MULTITHREADED" is worked out from the compiler's options.  GCC and Clang only reveal that a
+program uses threads when it's compiled with "-pthread" (or "-fopenmp", or as C++11 or later),
+so a program that starts threads without them should define "PF_MULTITHREADED" as 1 before
+<platform.h> is included; otherwise it's taken to be 0.
+
 "PF_DLL_EXPORT" is a call modifier to make a function or routine exportable from a DLL (for
 platforms that support DLL's).  "PF_DLL_IMPORT" makes a DLL function or routine available for a
 program or another DLL to call.
 
+Each file MAY also define the following macros to refine "PF_CPU" (they're defined as 0 later
+on by this file if they aren't):
+
+  PF_X86_LEVEL     The x86-64 micro-architecture level being targeted (1 to 4, for x86-64-v1
+                   through x86-64-v4) -- 0 if the CPU isn't x86-64
+  PF_ARM_LEVEL     The ARM architecture version being targeted (for example, 7 or 8) -- 0 if
+                   the CPU isn't an ARM CPU
+  PF_POWER_LEVEL   The POWER processor generation being targeted (for example, 8 for POWER8)
+                   -- 0 if the CPU isn't a POWER CPU or the generation isn't known
+
+Each file SHOULD also define "PF_ENDIAN" as "PF_ENDIAN_LITTLE" or "PF_ENDIAN_BIG" if the
+compiler's predefined macros give the byte order away.  Otherwise it's determined later on by
+this file (as well as it can be) from other common predefined macros and from "PF_CPU".  The
+"PF_ENDIAN_RUNTIME" macro defined by <platform/byteord.h> can be compared with "PF_ENDIAN" to
+verify it.
+
+Each file MAY also define any of the following SIMD capability macros as 1 if the compiler has
+been told that it can generate the corresponding instructions (they're defined as 0 later on by
+this file if they aren't):
+
+  PF_SIMD_SSE2, PF_SIMD_SSE3, PF_SIMD_SSSE3, PF_SIMD_SSE4_1, PF_SIMD_SSE4_2, PF_SIMD_AVX,
+  PF_SIMD_AVX2, PF_SIMD_FMA, PF_SIMD_AVX512F, PF_SIMD_AVX512BW, PF_SIMD_NEON, PF_SIMD_SVE
+
+Because they're always defined, they can be tested with "#if" rather than "#ifdef".
+"PF_SIMD_WIDTH_BYTES" (the width, in bytes, of the widest SIMD register that the compiler can
+use -- 0 if it can't use any) is then derived from them, unless the compiler's include file
+knows better (a fixed SVE vector length, for example).
+
+Each file MAY also define "PF_CACHE_LINE_SIZE" (the size, in bytes, of the CPU's cache lines)
+and "PF_PAGE_SIZE" (the size, in bytes, of the operating system's memory pages) if it knows
+them.  Otherwise they're estimated later on by this file from "PF_CPU" and "PF_OS".  Either one
+can also be defined before this file is included to override the estimate.  The cache line size
+mustn't depend on tuning options (such as GCC's "-mtune=..."):  it sets the size and layout of
+types, so files compiled with different options would otherwise disagree about them.  They're
+compile-time estimates only -- the run-time routines declared in <platform/cache.h> report the
+actual values.
+
+Each file SHOULD also define "PF_ALIGNAS(numBytes)" if the compiler can align a type or
+variable to more than its natural alignment, so that it can be coded before a variable's
+declaration or between "struct" or "class" and a type's name:
+
+  struct PF_ALIGNAS(16) Vector
+  {
+    float x, y, z, w;
+  };
+
+  PF_ALIGNAS(64) static long counters[16];
+
+(This is the opposite of the packing pragma macros, which can only reduce alignment.)  If it
+isn't defined then it's defined later on by this file as C++11's "alignas" or, failing that,
+as nothing -- so alignment that correctness depends on (rather than just speed) should also be
+checked at run time.  "PF_CACHE_ALIGNED" is then defined as "PF_ALIGNAS(PF_CACHE_LINE_SIZE)",
+to keep data that different threads write to on different cache lines.
+
+Each file MAY also define "PF_THREADS_API" as one of the "threads API type" values (see above)
+if it knows which threads API a multithreaded program should use.  Otherwise it's determined
+later on by this file:  "PF_THREADS_NONE" if "PF_MULTITHREADED" is 0, the operating system's
+native API (POSIX threads or Win32 threads) if there is one and C++11's "<thread>" if that's
+all there is.  Code can then select a thread-aware fast path at compile time:
+
+  #if (PF_THREADS_API == PF_THREADS_POSIX)
+    pthread_mutex_lock(&tableLock);
+  #elif (PF_THREADS_API == PF_THREADS_WIN32)
+    EnterCriticalSection(&tableLock);
+  #endif
+
+Each file MAY also define "PF_CPU_RELAX()" as a statement that tells the CPU it's in a spin-
+wait loop ("pause" on the x86, for example), so that a thread polling a lock or flag doesn't
+slow down the other hyperthread on its core and leaves the loop promptly when the value
+changes:
+
+  while (pf_atomic_load32(&ready, PF_MEMORY_ORDER_ACQUIRE) == 0)
+    PF_CPU_RELAX();
+
+If it isn't defined then it's defined later on by this file as a statement that does nothing.
+
+Each file MAY also define "PF_LIKELY(condition)" and "PF_UNLIKELY(condition)", which return
+"condition" (as 0 or 1) and tell the compiler which way it's expected to go, "PF_HOT" and
+"PF_COLD", which mark a function as often or rarely called, and "PF_NOINLINE" and
+"PF_FORCE_INLINE", which override the compiler's inlining decisions.  Together they keep
+error-handling code out of the way of the code that's usually run:
+
+  PF_COLD PF_NOINLINE static void reportError(const char* message);
+
+  PF_FORCE_INLINE int nextToken(Parser* parser)
+  {
+    if (PF_UNLIKELY(parser->next == parser->end))
+      reportError("unexpected end of input");
+    ...
+  }
+
+If any of them isn't defined then it's defined later on by this file as something harmless:
+"PF_FORCE_INLINE" as "PF_INLINE" (see below), "PF_LIKELY()" and "PF_UNLIKELY()" as the
+condition itself and the rest as nothing.
+
+Each file MAY also define the following, which let the optimizer assume things that it can't
+prove for itself -- that's what lets it vectorize a loop over arrays or move a call out of one
+without a run-time check and a slower fallback:
+
+  PF_RESTRICT                        A pointer qualifier (C99's "restrict"):  what the pointer
+                                     points to isn't accessed through any other pointer.
+
+  PF_PURE                            A function attribute:  the function has no side effects
+                                     and its result depends only on its parameters and on
+                                     (unchanged) memory.
+
+  PF_CONST_FN                        A function attribute:  the function has no side effects
+                                     and its result depends only on its parameters' values.
+
+  PF_ASSUME(condition)               A statement:  "condition" is always true (it mustn't have
+                                     side effects, since it may or may not be evaluated).
+
+  PF_ASSUME_ALIGNED(pointer, bytes)  An expression that returns "pointer" (as a "void*" if the
+                                     compiler supports it, so cast the result) and lets the
+                                     compiler assume that it's aligned to "bytes" bytes.
+
+  void scale(float* PF_RESTRICT to, const float* PF_RESTRICT from, size_t count)
+  {
+    PF_ASSUME(count % 8 == 0);
+    ...
+  }
+
+A wrong assumption makes the program's behaviour undefined.  If any of them isn't defined then
+it's defined later on by this file as something harmless:  "PF_RESTRICT" as C99's "restrict"
+when compiling C99 and as nothing otherwise, "PF_ASSUME()" as a statement that does nothing,
+"PF_ASSUME_ALIGNED()" as the pointer itself and the rest as nothing.
+
+Each file MAY also define "PF_PRAGMA(directive)", which turns "directive" (after replacing any
+macros in it) into a pragma directive.  Unlike "#pragma", it can be used in the expansion of
+another macro, and it works whether or not the compiler performs macro replacement in pragma
+directives.  If it isn't defined then it's defined later on by this file with C99's and
+C++11's "_Pragma()" operator if the compiler supports it, and is otherwise left undefined.
+
+Each file MAY also define the following loop optimization macros, which apply to the loop that
+immediately follows them:
+
+  PF_LOOP_VECTORIZE       Vectorize the loop even if the compiler doesn't think it's worth it.
+  PF_LOOP_NO_VECTORIZE    Don't vectorize the loop.
+  PF_LOOP_IVDEP           The loop's iterations don't depend on each other (through memory
+                          that the compiler can't see isn't shared), so vectorize it without
+                          checking.
+  PF_LOOP_UNROLL(count)   Unroll the loop "count" times.
+
+  PF_LOOP_IVDEP
+  for (i = 0; i < count; i++)
+    to[offsets[i]] += from[i];
+
+Any that aren't defined are defined later on by this file as nothing, so they're just hints.
+
+Each file MAY also define "PF_OPTIMIZE_FOR_SPEED_BEGIN" and "PF_OPTIMIZE_FOR_SIZE_BEGIN",
+which optimize the functions defined after them for speed or for size whatever the command
+line says, "PF_OPTIMIZE_END", which goes back to the command line's settings, and
+"PF_OPTIMIZE_FN(level)", which does the same for a single function ("level" is a string in
+GCC's format, "O3" or "Os" for example).  They're complete directives, so they needn't follow
+"#pragma":
+
+  PF_OPTIMIZE_FOR_SPEED_BEGIN                // fast even in an unoptimized (debug) build
+
+  void filter(float* samples, size_t count)
+  {
+    ...
+  }
+
+  PF_OPTIMIZE_END
+
+  PF_OPTIMIZE_FN("O3") void mix(float* to, const float* from, size_t count);
+
+Regions can't be nested portably.  Any that aren't defined are defined later on by this file as
+nothing, in which case the command line's settings apply throughout.
+
+Each file MAY also define "PF_THREAD_LOCAL" as the storage class that declares a thread-local
+variable (GCC's "__thread", for example), and "PF_TLS_INITIAL_EXEC" as an attribute that makes
+one quick to find from a shared library (one instruction instead of a call to the run-time
+library):
+
+  static PF_THREAD_LOCAL PF_TLS_INITIAL_EXEC unsigned long allocations;
+
+If "PF_THREAD_LOCAL" isn't defined then this file defines it as C++11's "thread_local" or, in a
+single-threaded program, as nothing (an ordinary static variable is then thread-local enough).
+If there's still no way to declare a thread-local variable then it stays undefined, so it
+should be tested with "#ifdef".  If "PF_TLS_INITIAL_EXEC" isn't defined then it's defined as
+nothing.
+
 Additionally, if a compiler doesn't support a native "bool" type then its compiler include file
 should define the "PF_BOOL_NOT_BUILT_IN" macro to have a simulated bool type generated later on
 by this file.
@@ -274,29 +488,513 @@ just take up comment space.
 
 #ifndef PLATFORM_H
 
-  #if (PF_CPU == PF_INTEL_X86)
-    #define PF_ENDIAN PF_ENDIAN_LITTLE
+  /*
+  If the compiler include file didn't determine the byte order then it's determined from the
+  macros that many compilers and operating systems predefine, then from the CPU type.  Some
+  operating systems' header files define both "_BIG_ENDIAN" and "_LITTLE_ENDIAN" (as values to
+  compare "_BYTE_ORDER" to), so either one only counts if the other isn't defined.
+
+  CPU's that can run either way are assumed to run the way that they usually do -- ARM CPU's
+  little-endian and PowerPC CPU's big-endian.  MIPS CPU's are evenly split, so their byte order
+  remains unknown if no macro gives it away.
+  */
+
+  #ifndef PF_ENDIAN
+    #if defined(__BIG_ENDIAN__) || (defined(_BIG_ENDIAN) && !defined(_LITTLE_ENDIAN)) ||      \
+        defined(__ARMEB__) || defined(__AARCH64EB__) || defined(__MIPSEB__) || defined(_MIPSEB)
+      #define PF_ENDIAN PF_ENDIAN_BIG
+    #elif defined(__LITTLE_ENDIAN__) || (defined(_LITTLE_ENDIAN) && !defined(_BIG_ENDIAN)) || \
+          defined(__ARMEL__) || defined(__AARCH64EL__) || defined(__MIPSEL__) ||              \
+          defined(_MIPSEL)
+      #define PF_ENDIAN PF_ENDIAN_LITTLE
+    #elif ((PF_CPU == PF_INTEL_X86)   || (PF_CPU == PF_AMD_X86_64)   ||                       \
+           (PF_CPU == PF_DEC_ALPHA)   || (PF_CPU == PF_DEC_VAX)      ||                       \
+           (PF_CPU == PF_NS_32000)    || (PF_CPU == PF_ARM_AARCH32)  ||                       \
+           (PF_CPU == PF_ARM_AARCH64) || (PF_CPU == PF_RISC_V))
+      #define PF_ENDIAN PF_ENDIAN_LITTLE
+    #elif ((PF_CPU == PF_MOTOROLA_68X00) || (PF_CPU == PF_AMD_29000) ||                       \
+           (PF_CPU == PF_IBM_POWERPC)    || (PF_CPU == PF_IBM_POWERPC64))
+      #define PF_ENDIAN PF_ENDIAN_BIG
+    #else
+      #define PF_ENDIAN PF_ENDIAN_UNKNOWN
+    #endif
   #endif
 
-  #if (PF_CPU == PF_MOTOROLA_68X00)
-    #define PF_ENDIAN PF_ENDIAN_BIG
+  #ifndef PF_X86_LEVEL
+    #define PF_X86_LEVEL 0
   #endif
 
-  #ifndef PF_ENDIAN
-    #define PF_ENDIAN PF_ENDIAN_UNKNOWN
+  #ifndef PF_ARM_LEVEL
+    #define PF_ARM_LEVEL 0
+  #endif
+
+  #ifndef PF_POWER_LEVEL
+    #define PF_POWER_LEVEL 0
+  #endif
+
+  #ifndef PF_SIMD_SSE2
+    #define PF_SIMD_SSE2 0
+  #endif
+  #ifndef PF_SIMD_SSE3
+    #define PF_SIMD_SSE3 0
+  #endif
+  #ifndef PF_SIMD_SSSE3
+    #define PF_SIMD_SSSE3 0
+  #endif
+  #ifndef PF_SIMD_SSE4_1
+    #define PF_SIMD_SSE4_1 0
+  #endif
+  #ifndef PF_SIMD_SSE4_2
+    #define PF_SIMD_SSE4_2 0
+  #endif
+  #ifndef PF_SIMD_AVX
+    #define PF_SIMD_AVX 0
+  #endif
+  #ifndef PF_SIMD_AVX2
+    #define PF_SIMD_AVX2 0
+  #endif
+  #ifndef PF_SIMD_FMA
+    #define PF_SIMD_FMA 0
+  #endif
+  #ifndef PF_SIMD_AVX512F
+    #define PF_SIMD_AVX512F 0
+  #endif
+  #ifndef PF_SIMD_AVX512BW
+    #define PF_SIMD_AVX512BW 0
+  #endif
+  #ifndef PF_SIMD_NEON
+    #define PF_SIMD_NEON 0
+  #endif
+  #ifndef PF_SIMD_SVE
+    #define PF_SIMD_SVE 0
+  #endif
+
+  #ifndef PF_SIMD_WIDTH_BYTES
+    #if PF_SIMD_AVX512F
+      #define PF_SIMD_WIDTH_BYTES 64
+    #elif PF_SIMD_AVX
+      #define PF_SIMD_WIDTH_BYTES 32
+    #elif (PF_SIMD_SSE2 || PF_SIMD_NEON || PF_SIMD_SVE)
+      #define PF_SIMD_WIDTH_BYTES 16
+    #else
+      #define PF_SIMD_WIDTH_BYTES 0
+    #endif
+  #endif
+
+  /*
+  Apple's AArch64 CPU's and IBM's POWER CPU's have 128-byte cache lines; nearly everything else
+  that's still in use, including other AArch64 CPU's, has 64-byte cache lines.  These are fixed
+  per CPU type; GCC's "__GCC_DESTRUCTIVE_SIZE" isn't used because it follows "-mtune=..." (and
+  can be as large as 256 for generic AArch64 tuning).  Mac OS uses 16 KiB pages on AArch64,
+  Unix on 64-bit PowerPC's is assumed to use 64 KiB pages (Linux usually does, and
+  overestimating is the safer mistake) and every operating system for the Alpha uses 8 KiB
+  pages; nearly everything else uses 4 KiB pages.
+  */
+
+  #ifndef PF_CACHE_LINE_SIZE
+    #if ((PF_CPU == PF_ARM_AARCH64) && (PF_OS == PF_MACOS)) || (PF_CPU == PF_IBM_POWERPC64)
+      #define PF_CACHE_LINE_SIZE 128
+    #else
+      #define PF_CACHE_LINE_SIZE 64
+    #endif
+  #endif
+
+  #ifndef PF_PAGE_SIZE
+    #if ((PF_CPU == PF_ARM_AARCH64) && (PF_OS == PF_MACOS))
+      #define PF_PAGE_SIZE 16384
+    #elif ((PF_CPU == PF_IBM_POWERPC64) && (PF_OS == PF_UNIX))
+      #define PF_PAGE_SIZE 65536
+    #elif (PF_CPU == PF_DEC_ALPHA)
+      #define PF_PAGE_SIZE 8192
+    #else
+      #define PF_PAGE_SIZE 4096
+    #endif
+  #endif
+
+  #ifndef PF_ALIGNAS
+    #if defined(__cplusplus) && (__cplusplus >= 201103L)
+      #define PF_ALIGNAS(numBytes) alignas(numBytes)
+    #else
+      #define PF_ALIGNAS(numBytes)
+    #endif
+  #endif
+
+  #ifndef PF_CACHE_ALIGNED
+    #define PF_CACHE_ALIGNED PF_ALIGNAS(PF_CACHE_LINE_SIZE)
+  #endif
+
+  /*
+  If the compiler can't compile a function once for each of several targets then it's compiled
+  once, for the default target.
+  */
+
+  #ifndef PF_TARGET_CLONES
+    #define PF_TARGET_CLONES(targets)
+  #endif
+
+  /*
+  A CPU without a spin-wait hint just spins.
+  */
+
+  #ifndef PF_CPU_RELAX
+    #define PF_CPU_RELAX() ((void)0)
+  #endif
+
+  /*
+  "PF_INLINE" declares a function that's defined in a header file.  C++ merges the copies of an
+  "inline" function, but a C99 "inline" definition isn't compiled on its own, so a call that
+  isn't inlined needs an external definition that no header file provides; a "static" function
+  gives each source file a copy of its own instead.  C89 has no "inline" at all.
+  */
+
+  #ifndef PF_INLINE
+    #if defined(__cplusplus)
+      #define PF_INLINE inline
+    #elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)
+      #define PF_INLINE static inline
+    #else
+      #define PF_INLINE static
+    #endif
+  #endif
+
+  /*
+  Without branch prediction, code placement or inlining hints, the compiler's own heuristics
+  are used.  Borland's and Watcom's compilers have none of them (Watcom controls inlining for
+  whole regions of code with the "PF_INLINE_EXPANSION_..." pragma directive macros instead).
+  */
+
+  #ifndef PF_LIKELY
+    #define PF_LIKELY(condition) ((condition) != 0)
+  #endif
+  #ifndef PF_UNLIKELY
+    #define PF_UNLIKELY(condition) ((condition) != 0)
+  #endif
+
+  #ifndef PF_HOT
+    #define PF_HOT
+  #endif
+  #ifndef PF_COLD
+    #define PF_COLD
+  #endif
+
+  #ifndef PF_NOINLINE
+    #define PF_NOINLINE
+  #endif
+  #ifndef PF_FORCE_INLINE
+    #define PF_FORCE_INLINE PF_INLINE
+  #endif
+
+  /*
+  Without aliasing, purity or other hints (Borland's and Watcom's compilers have none), the
+  optimizer relies on what it can prove.
+  */
+
+  #ifndef PF_RESTRICT
+    #if !defined(__cplusplus) && defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)
+      #define PF_RESTRICT restrict
+    #else
+      #define PF_RESTRICT
+    #endif
+  #endif
+
+  #ifndef PF_PURE
+    #define PF_PURE
+  #endif
+  #ifndef PF_CONST_FN
+    #define PF_CONST_FN
+  #endif
+
+  #ifndef PF_ASSUME
+    #define PF_ASSUME(condition) ((void)0)
+  #endif
+  #ifndef PF_ASSUME_ALIGNED
+    #define PF_ASSUME_ALIGNED(pointer, alignment) (pointer)
   #endif
 
   /*
-  Need to determine endian for the following CPU's:
-
-    PF_AMD_29000,
-    PF_DEC_ALPHA,
-    PF_DEC_VAX,
-    PF_IBM_POWERPC,
-    PF_MIPS,
-    PF_NS_32000,
+  C99 and C++11 have a standard operator for pragma directives in macros.  Loop and function
+  optimization hints that the compiler doesn't support are ignored.
   */
 
+  #ifndef PF_PRAGMA
+    #if (defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)) ||                       \
+        (defined(__cplusplus) && (__cplusplus >= 201103L))
+      #define PF_STRINGIZE_PRAGMA(directive) _Pragma(#directive)
+      #define PF_PRAGMA(directive)           PF_STRINGIZE_PRAGMA(directive)
+    #endif
+  #endif
+
+  #ifndef PF_LOOP_VECTORIZE
+    #define PF_LOOP_VECTORIZE
+  #endif
+  #ifndef PF_LOOP_NO_VECTORIZE
+    #define PF_LOOP_NO_VECTORIZE
+  #endif
+  #ifndef PF_LOOP_IVDEP
+    #define PF_LOOP_IVDEP
+  #endif
+  #ifndef PF_LOOP_UNROLL
+    #define PF_LOOP_UNROLL(count)
+  #endif
+
+  #ifndef PF_OPTIMIZE_FOR_SPEED_BEGIN
+    #define PF_OPTIMIZE_FOR_SPEED_BEGIN
+  #endif
+  #ifndef PF_OPTIMIZE_FOR_SIZE_BEGIN
+    #define PF_OPTIMIZE_FOR_SIZE_BEGIN
+  #endif
+  #ifndef PF_OPTIMIZE_END
+    #define PF_OPTIMIZE_END
+  #endif
+  #ifndef PF_OPTIMIZE_FN
+    #define PF_OPTIMIZE_FN(level)
+  #endif
+
+  /*
+  Each pragma directive macro that the compiler include file defined gets a "PF_PRAGMA_..."
+  counterpart that expands to the whole directive, for use inside other macros.
+  */
+
+  #ifdef PF_PRAGMA
+
+    // Precompiled headers control
+
+    #ifdef PF_PRECOMPILED_HEADERS_DONE
+      #define PF_PRAGMA_PRECOMPILED_HEADERS_DONE PF_PRAGMA(PF_PRECOMPILED_HEADERS_DONE)
+    #endif
+    #ifdef PF_PRECOMPILED_HEADERS_DONE_SET_FILE
+      #define PF_PRAGMA_PRECOMPILED_HEADERS_DONE_SET_FILE(file)                               \
+        PF_PRAGMA(PF_PRECOMPILED_HEADERS_DONE_SET_FILE(file))
+    #endif
+
+    // Class/structure member packing
+
+    #ifdef PF_PACKING_RESET
+      #define PF_PRAGMA_PACKING_RESET PF_PRAGMA(PF_PACKING_RESET)
+    #endif
+    #ifdef PF_PACKING_SET
+      #define PF_PRAGMA_PACKING_SET(numBytes) PF_PRAGMA(PF_PACKING_SET(numBytes))
+    #endif
+    #ifdef PF_PACKING_PUSH
+      #define PF_PRAGMA_PACKING_PUSH PF_PRAGMA(PF_PACKING_PUSH)
+    #endif
+    #ifdef PF_PACKING_PUSH_AND_LABEL
+      #define PF_PRAGMA_PACKING_PUSH_AND_LABEL(label)                                         \
+        PF_PRAGMA(PF_PACKING_PUSH_AND_LABEL(label))
+    #endif
+    #ifdef PF_PACKING_POP
+      #define PF_PRAGMA_PACKING_POP PF_PRAGMA(PF_PACKING_POP)
+    #endif
+    #ifdef PF_PACKING_POP_TO_LABEL
+      #define PF_PRAGMA_PACKING_POP_TO_LABEL(label) PF_PRAGMA(PF_PACKING_POP_TO_LABEL(label))
+    #endif
+
+    // Intrinsic routine/function control
+
+    #ifdef PF_DECLARE_ROUTINE_INTRINSIC
+      #define PF_PRAGMA_DECLARE_ROUTINE_INTRINSIC(routine)                                    \
+        PF_PRAGMA(PF_DECLARE_ROUTINE_INTRINSIC(routine))
+    #endif
+    #ifdef PF_DECLARE_ROUTINE_NON_INTRINSIC
+      #define PF_PRAGMA_DECLARE_ROUTINE_NON_INTRINSIC(routine)                                \
+        PF_PRAGMA(PF_DECLARE_ROUTINE_NON_INTRINSIC(routine))
+    #endif
+
+    // Recursive inline expansion control
+
+    #ifdef PF_INLINE_EXPANSION_DEPTH_RESET
+      #define PF_PRAGMA_INLINE_EXPANSION_DEPTH_RESET PF_PRAGMA(PF_INLINE_EXPANSION_DEPTH_RESET)
+    #endif
+    #ifdef PF_INLINE_EXPANSION_DEPTH_SET
+      #define PF_PRAGMA_INLINE_EXPANSION_DEPTH_SET(depth)                                     \
+        PF_PRAGMA(PF_INLINE_EXPANSION_DEPTH_SET(depth))
+    #endif
+    #ifdef PF_INLINE_EXPANSION_RECURSION_RESET
+      #define PF_PRAGMA_INLINE_EXPANSION_RECURSION_RESET                                      \
+        PF_PRAGMA(PF_INLINE_EXPANSION_RECURSION_RESET)
+    #endif
+    #ifdef PF_INLINE_EXPANSION_RECURSION_OFF
+      #define PF_PRAGMA_INLINE_EXPANSION_RECURSION_OFF                                        \
+        PF_PRAGMA(PF_INLINE_EXPANSION_RECURSION_OFF)
+    #endif
+    #ifdef PF_INLINE_EXPANSION_RECURSION_ON
+      #define PF_PRAGMA_INLINE_EXPANSION_RECURSION_ON                                         \
+        PF_PRAGMA(PF_INLINE_EXPANSION_RECURSION_ON)
+    #endif
+
+    // Enumeration type control
+
+    #ifdef PF_ENUM_TYPE_RESET
+      #define PF_PRAGMA_ENUM_TYPE_RESET PF_PRAGMA(PF_ENUM_TYPE_RESET)
+    #endif
+    #ifdef PF_ENUM_TYPE_PUSH_AND_SET_INT
+      #define PF_PRAGMA_ENUM_TYPE_PUSH_AND_SET_INT PF_PRAGMA(PF_ENUM_TYPE_PUSH_AND_SET_INT)
+    #endif
+    #ifdef PF_ENUM_TYPE_PUSH_AND_SET_MINIMAL
+      #define PF_PRAGMA_ENUM_TYPE_PUSH_AND_SET_MINIMAL                                        \
+        PF_PRAGMA(PF_ENUM_TYPE_PUSH_AND_SET_MINIMAL)
+    #endif
+    #ifdef PF_ENUM_TYPE_POP
+      #define PF_PRAGMA_ENUM_TYPE_POP PF_PRAGMA(PF_ENUM_TYPE_POP)
+    #endif
+
+    // Static data initialization control
+
+    #ifdef PF_STATIC_DATA_INITIALIZE_PRIORITY
+      #define PF_PRAGMA_STATIC_DATA_INITIALIZE_PRIORITY(priority)                             \
+        PF_PRAGMA(PF_STATIC_DATA_INITIALIZE_PRIORITY(priority))
+    #endif
+    #ifdef PF_STATIC_DATA_INITIALIZE_PRIORITY_LIBRARY
+      #define PF_PRAGMA_STATIC_DATA_INITIALIZE_PRIORITY_LIBRARY                               \
+        PF_PRAGMA(PF_STATIC_DATA_INITIALIZE_PRIORITY_LIBRARY)
+    #endif
+    #ifdef PF_STATIC_DATA_INITIALIZE_PRIORITY_PROGRAM
+      #define PF_PRAGMA_STATIC_DATA_INITIALIZE_PRIORITY_PROGRAM                               \
+        PF_PRAGMA(PF_STATIC_DATA_INITIALIZE_PRIORITY_PROGRAM)
+    #endif
+
+    // Class compilation control
+
+    #ifdef PF_CLASS_DEPENDENCY_TRACKING_OFF
+      #define PF_PRAGMA_CLASS_DEPENDENCY_TRACKING_OFF                                         \
+        PF_PRAGMA(PF_CLASS_DEPENDENCY_TRACKING_OFF)
+    #endif
+    #ifdef PF_CLASS_DEPENDENCY_TRACKING_ON
+      #define PF_PRAGMA_CLASS_DEPENDENCY_TRACKING_ON PF_PRAGMA(PF_CLASS_DEPENDENCY_TRACKING_ON)
+    #endif
+    #ifdef PF_CLASS_HIDDEN_DISPS_VIRTUAL_BASES_OFF
+      #define PF_PRAGMA_CLASS_HIDDEN_DISPS_VIRTUAL_BASES_OFF                                  \
+        PF_PRAGMA(PF_CLASS_HIDDEN_DISPS_VIRTUAL_BASES_OFF)
+    #endif
+    #ifdef PF_CLASS_HIDDEN_DISPS_VIRTUAL_BASES_ON
+      #define PF_PRAGMA_CLASS_HIDDEN_DISPS_VIRTUAL_BASES_ON                                   \
+        PF_PRAGMA(PF_CLASS_HIDDEN_DISPS_VIRTUAL_BASES_ON)
+    #endif
+
+    // Stack monitoring control
+
+    #ifdef PF_STACK_CHECKING_OFF
+      #define PF_PRAGMA_STACK_CHECKING_OFF PF_PRAGMA(PF_STACK_CHECKING_OFF)
+    #endif
+    #ifdef PF_STACK_CHECKING_ON
+      #define PF_PRAGMA_STACK_CHECKING_ON PF_PRAGMA(PF_STACK_CHECKING_ON)
+    #endif
+    #ifdef PF_STACK_CHECKING_RESET
+      #define PF_PRAGMA_STACK_CHECKING_RESET PF_PRAGMA(PF_STACK_CHECKING_RESET)
+    #endif
+
+    // Compiler output
+
+    #ifdef PF_OUTPUT_ON_COMPILE
+      #define PF_PRAGMA_OUTPUT_ON_COMPILE(text) PF_PRAGMA(PF_OUTPUT_ON_COMPILE(text))
+    #endif
+    #ifdef PF_PUT_TEXT_IN_TARGET
+      #define PF_PRAGMA_PUT_TEXT_IN_TARGET(target, text)                                      \
+        PF_PRAGMA(PF_PUT_TEXT_IN_TARGET(target, text))
+    #endif
+    #ifdef PF_PUT_COMPILER_INFO_TEXT_IN_OBJ_FILE
+      #define PF_PRAGMA_PUT_COMPILER_INFO_TEXT_IN_OBJ_FILE                                    \
+        PF_PRAGMA(PF_PUT_COMPILER_INFO_TEXT_IN_OBJ_FILE)
+    #endif
+    #ifdef PF_OUTPUT_ON_COMPILE_CLASS
+      #define PF_PRAGMA_OUTPUT_ON_COMPILE_CLASS PF_PRAGMA(PF_OUTPUT_ON_COMPILE_CLASS)
+    #endif
+    #ifdef PF_OUTPUT_ON_COMPILE_ENUM
+      #define PF_PRAGMA_OUTPUT_ON_COMPILE_ENUM PF_PRAGMA(PF_OUTPUT_ON_COMPILE_ENUM)
+    #endif
+
+    // Link control
+
+    #ifdef PF_LINK_WITH
+      #define PF_PRAGMA_LINK_WITH(file) PF_PRAGMA(PF_LINK_WITH(file))
+    #endif
+
+    // Browse information gathering control
+
+    #ifdef PF_BROWSE_INFO_GATHER_REFS_TO_OFF
+      #define PF_PRAGMA_BROWSE_INFO_GATHER_REFS_TO_OFF(name)                                  \
+        PF_PRAGMA(PF_BROWSE_INFO_GATHER_REFS_TO_OFF(name))
+    #endif
+    #ifdef PF_BROWSE_INFO_GATHER_REFS_TO_ON
+      #define PF_PRAGMA_BROWSE_INFO_GATHER_REFS_TO_ON(name)                                   \
+        PF_PRAGMA(PF_BROWSE_INFO_GATHER_REFS_TO_ON(name))
+    #endif
+    #ifdef PF_BROWSE_INFO_GATHER_REFERENCES_OFF
+      #define PF_PRAGMA_BROWSE_INFO_GATHER_REFERENCES_OFF                                     \
+        PF_PRAGMA(PF_BROWSE_INFO_GATHER_REFERENCES_OFF)
+    #endif
+    #ifdef PF_BROWSE_INFO_GATHER_REFERENCES_ON
+      #define PF_PRAGMA_BROWSE_INFO_GATHER_REFERENCES_ON                                      \
+        PF_PRAGMA(PF_BROWSE_INFO_GATHER_REFERENCES_ON)
+    #endif
+    #ifdef PF_BROWSE_INFO_GATHERING_OFF
+      #define PF_PRAGMA_BROWSE_INFO_GATHERING_OFF PF_PRAGMA(PF_BROWSE_INFO_GATHERING_OFF)
+    #endif
+    #ifdef PF_BROWSE_INFO_GATHERING_ON
+      #define PF_PRAGMA_BROWSE_INFO_GATHERING_ON PF_PRAGMA(PF_BROWSE_INFO_GATHERING_ON)
+    #endif
+
+    // Miscellaneous
+
+    #ifdef PF_HEADER_FILE_ALIAS
+      #define PF_PRAGMA_HEADER_FILE_ALIAS(alias, actual)                                      \
+        PF_PRAGMA(PF_HEADER_FILE_ALIAS(alias, actual))
+    #endif
+    #ifdef PF_INCLUDE_ONCE_ONLY
+      #define PF_PRAGMA_INCLUDE_ONCE_ONLY PF_PRAGMA(PF_INCLUDE_ONCE_ONLY)
+    #endif
+    #ifdef PF_SETLOCALE
+      #define PF_PRAGMA_SETLOCALE(locale) PF_PRAGMA(PF_SETLOCALE(locale))
+    #endif
+    #ifdef PF_REUSE_DUPLICATE_STRINGS_OFF
+      #define PF_PRAGMA_REUSE_DUPLICATE_STRINGS_OFF PF_PRAGMA(PF_REUSE_DUPLICATE_STRINGS_OFF)
+    #endif
+    #ifdef PF_REUSE_DUPLICATE_STRINGS_ON
+      #define PF_PRAGMA_REUSE_DUPLICATE_STRINGS_ON PF_PRAGMA(PF_REUSE_DUPLICATE_STRINGS_ON)
+    #endif
+    #ifdef PF_TEMPLATE_RECURSIVE_EXPANSION_LIMIT
+      #define PF_PRAGMA_TEMPLATE_RECURSIVE_EXPANSION_LIMIT(limit)                             \
+        PF_PRAGMA(PF_TEMPLATE_RECURSIVE_EXPANSION_LIMIT(limit))
+    #endif
+
+  #endif
+
+  /*
+  A single-threaded program has no threads API.  Otherwise the operating system's own API is
+  preferred to C++11's, which is usually built on top of it anyway.  POSIX is checked first so
+  that Unix emulations on Windows (Cygwin, for example) get the API that they provide.
+  */
+
+  #ifndef PF_THREADS_API
+    #if !PF_MULTITHREADED
+      #define PF_THREADS_API PF_THREADS_NONE
+    #elif (PF_OS == PF_UNIX) || defined(__unix__) || defined(__APPLE__)
+      #define PF_THREADS_API PF_THREADS_POSIX
+    #elif (PF_OS == PF_WIN32) || defined(_WIN32)
+      #define PF_THREADS_API PF_THREADS_WIN32
+    #elif defined(__cplusplus) && (__cplusplus >= 201103L)
+      #define PF_THREADS_API PF_THREADS_CPP11
+    #else
+      #define PF_THREADS_API PF_THREADS_NONE
+    #endif
+  #endif
+
+  /*
+  A variable in a single-threaded program can only be seen by one thread anyway.
+  */
+
+  #ifndef PF_THREAD_LOCAL
+    #if !PF_MULTITHREADED
+      #define PF_THREAD_LOCAL
+    #elif defined(__cplusplus) && (__cplusplus >= 201103L)
+      #define PF_THREAD_LOCAL thread_local
+    #endif
+  #endif
+
+  #ifndef PF_TLS_INITIAL_EXEC
+    #define PF_TLS_INITIAL_EXEC
+  #endif
+
 #endif
 
 // ============================================================================================
@@ -0,0 +1,63 @@
+#ifndef PLATFORM_AFFINITY_H
+#define PLATFORM_AFFINITY_H
+
+// ============================================================================================
+//
+// affinity.h -- Thread Affinity and CPU Placement
+//
+// ============================================================================================
+
+/*
+The operating system moves threads from CPU to CPU as it sees fit.  Each move costs the thread
+the contents of its caches and, on a computer with more than one socket, can put it on a
+different NUMA node from its memory (see <platform/numa.h>).  The routines declared here pin
+the calling thread to a CPU or a node, and suggest which CPUs a set of worker threads should
+be pinned to:
+
+  #include <platform/affinity.h>
+
+  int cpus[WORKERS];
+
+  pf_cpu_placement(cpus, WORKERS);
+  ...
+  pf_thread_pin(cpus[worker]);                                   // in worker number "worker"
+
+"pf_cpu_placement()" fills the array with CPU numbers ordered so that each worker gets a
+physical core of its own for as long as there are free ones:  one hardware thread of every
+core comes first and SMT siblings (hyperthreads) only come after all of them, since two
+busy threads on one core compete for its execution units and caches.  Within each of those
+rounds, cores are ordered by package (socket), so a small set of workers shares one last-level
+cache and one node's memory rather than being spread across sockets.  If there are more
+workers than CPUs then the list starts again from the beginning.
+
+"pf_thread_pin()" and "pf_thread_pin_node()" return non-zero if they succeeded and 0 if they
+didn't (the CPU or node doesn't exist, the process isn't allowed to use it, or pinning isn't
+supported).  "pf_thread_pin_node()" lets the thread run on any CPU of the node, which is
+usually better than pinning it to one CPU when it's its memory that matters.
+
+The topology is read once (either during static initialization or on the first call,
+whichever comes first) and the result is cached.  On Linux it's read from
+"/sys/devices/system/cpu/cpuN/topology", restricted to the CPUs that the process is allowed to
+use; on Windows it comes from "GetLogicalProcessorInformation()", and only the first processor
+group (64 CPUs) can be used.  Everywhere else the CPUs are listed in numerical order and
+pinning always fails.
+
+"src/code/affinity.cpp" must be compiled into the program.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <platform.h>
+
+// ============================================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================================
+
+int pf_cpu_count(void);
+int pf_cpu_placement(int*, const int);
+int pf_thread_pin(const int);
+int pf_thread_pin_node(const int);
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef PLATFORM_ALIGN_H
+#define PLATFORM_ALIGN_H
+
+// ============================================================================================
+//
+// align.h -- False-Sharing Avoidance
+//
+// ============================================================================================
+
+/*
+When two threads repeatedly write to different variables that happen to share a cache line,
+the line has to move back and forth between the two CPU's caches on every write ("false
+sharing"), which can make both threads several times slower.  This header file defines
+"pf::padded<T>", which holds a "T" on a cache line (or lines) of its own:
+
+  #include <platform/align.h>
+
+  static pf::padded<unsigned long> counters[MAX_THREADS];    // one counter per thread
+
+  counters[thread].value++;                                    // or "(*counters[thread])++"
+
+A "pf::padded<T>" is aligned to "PF_CACHE_LINE_SIZE" bytes and its size is a multiple of
+"PF_CACHE_LINE_SIZE", so every element of an array of them starts on a new cache line.  Before
+C++17, "new" doesn't honour alignments greater than the alignment of "max_align_t", so arrays
+of them should be allocated with "pf_aligned_alloc()" (see <platform/alloc.h>) instead.
+
+The size is rounded up with padding bytes, so it doesn't depend on the compiler supporting
+"PF_ALIGNAS()".  Where it doesn't (before C++11, unless the compiler has an attribute of its
+own), only an array allocated with "pf_aligned_alloc()" is sure to start on a cache line; a
+static or automatic one may share its first and last cache lines with other variables.
+
+NOTE:  This header file requires a C++ compiler that supports namespaces and templates.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <platform.h>
+
+namespace pf
+{
+
+// ============================================================================================
+// CLASS DEFINITIONS
+// ============================================================================================
+
+// The bytes that round the size of a "padded<T>" up to a multiple of the cache line size
+
+template <unsigned numBytes> struct cache_line_padding
+{
+  char _bytes[numBytes];
+};
+
+template <> struct cache_line_padding<0>
+{
+};
+
+template <class T> struct PF_CACHE_ALIGNED padded:
+  private cache_line_padding<(PF_CACHE_LINE_SIZE - sizeof(T) % PF_CACHE_LINE_SIZE) %
+                             PF_CACHE_LINE_SIZE>
+{
+  T value;                                                                // the padded value
+
+  padded(): value() {}
+  padded(const T& initialValue): value(initialValue) {}
+
+  T&       operator*()        {return value;}
+  const T& operator*() const  {return value;}
+  T*       operator->()       {return &value;}
+  const T* operator->() const {return &value;}
+};
+
+}
+
+#endif
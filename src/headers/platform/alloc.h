@@ -0,0 +1,95 @@
+#ifndef PLATFORM_ALLOC_H
+#define PLATFORM_ALLOC_H
+
+// ============================================================================================
+//
+// alloc.h -- Aligned and Large-Page Memory Allocation
+//
+// ============================================================================================
+
+/*
+Every compiler's library has a different way of allocating memory with more than the usual
+alignment ("_aligned_malloc()", "posix_memalign()", "memalign()", etc.), and each one must be
+matched with its own way of freeing it.  "pf_aligned_alloc()" and "pf_aligned_free()" hide the
+differences:
+
+  #include <platform/alloc.h>
+
+  float* samples = (float*)pf_aligned_alloc(count * sizeof(float), PF_SIMD_WIDTH_BYTES);
+  ...
+  pf_aligned_free(samples);
+
+Programs that work with very large blocks of memory (gigabytes) spend a surprising amount of
+time translating virtual addresses when the blocks are made of ordinary 4 KiB pages, because
+the CPU's translation look-aside buffer can only hold a few thousand translations.  Huge pages
+(2 MiB on the x86-64 and AArch64) cover 512 times as much memory per translation.
+"pf_large_alloc()" tries to get them, falling back step by step until it gets something:
+
+  PF_LARGE_PAGES_HUGE         Explicit huge pages ("MAP_HUGETLB" on Linux, "MEM_LARGE_PAGES"
+                              on Windows), which the system administrator must have reserved
+                              (Linux) or granted the "Lock pages in memory" privilege for
+                              (Windows).
+  PF_LARGE_PAGES_TRANSPARENT  Ordinary pages, aligned to a huge page and marked with
+                              "madvise(MADV_HUGEPAGE)" so that Linux's transparent huge page
+                              support can promote them to huge pages (it's not guaranteed to).
+  PF_LARGE_PAGES_NORMAL       Ordinary pages, mapped directly from the operating system.
+  PF_LARGE_PAGES_HEAP         Memory from the heap (on operating systems that can't map pages).
+
+The tier that was got is reported so that the program can log it (a program that was expected
+to get huge pages and didn't will be noticeably slower, and the cause isn't otherwise obvious):
+
+  int   tier;
+  void* index = pf_large_alloc(indexSize, &tier);
+
+  if (tier != PF_LARGE_PAGES_HUGE)
+    fprintf(stderr, "The index isn't in huge pages (tier %d).\n", tier);
+  ...
+  pf_large_free(index, indexSize);
+
+A block from "pf_large_alloc()" is always aligned to at least a page, and its size is rounded
+up to a multiple of "PF_LARGE_PAGE_SIZE".  It's zero-filled except, possibly, on the heap tier.
+"PF_LARGE_PAGE_SIZE" (2 MiB unless it's defined before this file is included) is only a
+rounding granule:  on Linux, explicit huge pages must be of that size (the default size may
+differ), and on Windows they're only used if it's a multiple of "GetLargePageMinimum()".
+
+"src/code/alloc.cpp" must be compiled into the program.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stddef.h>
+
+#include <platform.h>
+
+// ============================================================================================
+// MACRO DEFINITIONS
+// ============================================================================================
+
+// The granule that large blocks are rounded up and aligned to (the smallest huge page size on
+// both the x86-64 and AArch64, when AArch64 uses 4 KiB ordinary pages) -- not necessarily the
+// operating system's huge page size, which is only known at run time
+
+#ifndef PF_LARGE_PAGE_SIZE
+  #define PF_LARGE_PAGE_SIZE 0x200000UL
+#endif
+
+// Tiers reported by "pf_large_alloc()", from best to worst
+
+#define PF_LARGE_PAGES_NONE        0
+#define PF_LARGE_PAGES_HUGE        1
+#define PF_LARGE_PAGES_TRANSPARENT 2
+#define PF_LARGE_PAGES_NORMAL      3
+#define PF_LARGE_PAGES_HEAP        4
+
+// ============================================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================================
+
+void* pf_aligned_alloc(const size_t, const size_t);
+void  pf_aligned_free(void*);
+void* pf_large_alloc(const size_t, int*);
+void  pf_large_free(void*, const size_t);
+
+#endif
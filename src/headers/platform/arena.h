@@ -0,0 +1,145 @@
+#ifndef PLATFORM_ARENA_H
+#define PLATFORM_ARENA_H
+
+// ============================================================================================
+//
+// arena.h -- Arena (Bump) Allocation
+//
+// ============================================================================================
+
+/*
+Code that makes many small allocations which all die at the same time (everything allocated
+while handling one request, for example) spends much of its time in "malloc()" and "free()",
+and in a multithreaded program the heap's locks are contended as well.  A "pf::arena" hands
+out memory by advancing a pointer through large chunks and frees all of it at once:
+
+  #include <platform/arena.h>
+
+  pf::arena scratch;
+
+  while (getRequest(request))
+  {
+    Token* tokens = (Token*)scratch.allocate(count * sizeof(Token));
+    ...
+    scratch.reset();                                      // everything allocated above is gone
+  }
+
+"reset()" keeps the chunks for reuse, so an arena that's reset regularly soon stops asking
+the operating system for memory at all.  The chunks are returned when the arena is destroyed
+(or "release()" is called).  Destructors of objects constructed in an arena are never called
+by the arena.
+
+Chunks of "PF_LARGE_PAGE_SIZE" bytes or more come from "pf_large_alloc()" and so are backed by
+huge pages where possible; smaller ones come from "pf_aligned_alloc()".  Every chunk starts on
+a cache line.
+
+A "pf::arena" isn't thread-safe:  use one per thread (or one per request).
+
+"src/code/arena.cpp" and "src/code/alloc.cpp" must be compiled into the program.
+
+NOTE:  This header file requires a C++ compiler that supports namespaces.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stddef.h>
+
+#include <platform.h>
+#include <platform/alloc.h>
+
+// ============================================================================================
+// MACRO DEFINITIONS
+// ============================================================================================
+
+// The default size of an arena's chunks
+
+#ifndef PF_ARENA_CHUNK_SIZE
+  #define PF_ARENA_CHUNK_SIZE 0x10000UL
+#endif
+
+namespace pf
+{
+
+// ============================================================================================
+// CLASS DEFINITIONS
+// ============================================================================================
+
+class arena
+{
+  public:
+    arena(const size_t chunkSize = PF_ARENA_CHUNK_SIZE);
+    ~arena();
+
+    void* allocate(const size_t size, const size_t alignment = sizeof(void*));
+    void  reset();
+    void  release();
+
+    size_t reserved() const {return _reserved;}
+
+  private:
+    struct chunk
+    {
+      chunk* next;                                                   // the next chunk, or NULL
+      size_t size;                          // the chunk's size in bytes, including this header
+    };
+
+    chunk* _first;                                                  // the first chunk, or NULL
+    chunk* _current;                                 // the chunk being allocated from, or NULL
+    char*  _next;                                           // the next free byte in "_current"
+    char*  _end;                                                       // the end of "_current"
+    size_t _chunkSize;                                             // the usual size of a chunk
+    size_t _reserved;                                       // the total size of all the chunks
+
+    void* grow(const size_t, const size_t);
+
+    arena(const arena&);                                                        // not copyable
+    arena& operator=(const arena&);
+};
+
+// ============================================================================================
+// INLINE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+inline void* arena::allocate
+(
+  const size_t size,                                              // the block's size, in bytes
+  const size_t alignment                         // the block's alignment (a power of 2, bytes)
+)
+
+/*
+This function allocates a block of memory from the arena.
+
+PRECONDITIONS:
+"alignment" must be a power of 2 no greater than "PF_CACHE_LINE_SIZE".
+
+POSTCONDITIONS:
+A pointer to the block is returned, or NULL if a new chunk was needed and couldn't be
+allocated.  The block remains valid until "reset()" or "release()" is called or the arena is
+destroyed.
+*/
+
+{
+  if (_next != NULL)                               // no arithmetic on "_next" until it's valid
+  {
+    const size_t padding = (0 - (size_t)_next) & (alignment - 1);
+    const size_t left    = (size_t)(_end - _next);
+
+    if ((padding <= left) && (size <= left - padding))
+    {
+      char* const block = _next + padding;
+
+      _next = block + size;
+      return block;
+    }
+  }
+
+  return grow(size, alignment);
+}
+
+}
+
+#endif
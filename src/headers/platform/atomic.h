@@ -0,0 +1,666 @@
+#ifndef PLATFORM_ATOMIC_H
+#define PLATFORM_ATOMIC_H
+
+// ============================================================================================
+//
+// atomic.h -- Atomic Operations and Memory Ordering
+//
+// ============================================================================================
+
+/*
+This header file defines atomic types and inline functions that operate on them, for lock-free
+counters, flags and queues that work with every compiler that has some form of atomic
+operations:
+
+  pf_atomic32_t, pf_atomic64_t   32- and 64-bit signed integers
+  pf_atomic_ptr_t                a "void*"
+
+  int32_t pf_atomic_load32(const pf_atomic32_t* object, int order)
+  void    pf_atomic_store32(pf_atomic32_t* object, int32_t value, int order)
+  int32_t pf_atomic_exchange32(pf_atomic32_t* object, int32_t value, int order)
+  int     pf_atomic_cas32(pf_atomic32_t* object, int32_t* expected, int32_t desired, int order)
+  int32_t pf_atomic_fetch_add32(pf_atomic32_t* object, int32_t delta, int order)
+
+and likewise "..._64()" and (except for "fetch_add") "..._ptr()".  "pf_atomic_cas...()" stores
+"desired" in "*object" and returns non-zero if "*object" is "*expected"; otherwise it copies
+"*object" to "*expected" and returns 0.  "pf_atomic_fetch_add...()" and
+"pf_atomic_exchange...()" return the previous value.
+
+"order" is one of "PF_MEMORY_ORDER_RELAXED", "PF_MEMORY_ORDER_ACQUIRE",
+"PF_MEMORY_ORDER_RELEASE", "PF_MEMORY_ORDER_ACQ_REL" or "PF_MEMORY_ORDER_SEQ_CST", with the
+same meanings as C++11's "std::memory_order" values (an acquire store or a release load is
+treated as relaxed).  It should be a constant so that the compiler can discard the code for
+the other orderings.  For example, a single-producer queue publishes an item with:
+
+  buffer[head % SIZE] = item;
+  pf_atomic_store32(&queue->head, head + 1, PF_MEMORY_ORDER_RELEASE);
+
+The following functions order memory accesses without accessing anything:
+
+  void pf_fence_acquire(void)        later accesses can't move before earlier loads
+  void pf_fence_release(void)        earlier accesses can't move after later stores
+  void pf_fence_seq_cst(void)        no access can move across it in either direction
+  void pf_compiler_barrier(void)     the compiler can't move accesses across it (the CPU can)
+
+"PF_ATOMIC_API" says how they're implemented (it can be defined before this file is included
+to choose a different implementation):
+
+  PF_ATOMIC_GNU        GCC's (4.7 or later) and Clang's "__atomic_...()" built-in functions
+  PF_ATOMIC_GNU_SYNC   GCC's older "__sync_...()" built-in functions, which are always full
+                       barriers (GCC 4.1 to 4.6)
+  PF_ATOMIC_MICROSOFT  Microsoft's "_Interlocked...()" intrinsic functions (Visual C++ 2005 or
+                       later)
+  PF_ATOMIC_CPP11      C++11's "std::atomic" (any other C++11 compiler) -- the atomic types are
+                       then "std::atomic" types, so they must be initialized with parentheses
+                       ("pf_atomic32_t count(0);") rather than "="
+  PF_ATOMIC_NONE       Ordinary reads and writes of "volatile" variables, which are only safe
+                       in a single-threaded program
+
+NOTE:  "PF_ATOMIC_NONE" is only chosen when nothing else is available.  If "PF_MULTITHREADED"
+is 1 then a compiler-specific implementation should be added instead of relying on it.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stdint.h>
+
+#include <platform.h>
+
+// ============================================================================================
+// MACRO DEFINITIONS
+// ============================================================================================
+
+// Implementations
+
+#define PF_ATOMIC_NONE      0
+#define PF_ATOMIC_GNU       1
+#define PF_ATOMIC_GNU_SYNC  2
+#define PF_ATOMIC_MICROSOFT 3
+#define PF_ATOMIC_CPP11     4
+
+#ifndef PF_ATOMIC_API
+  #if (PF_COMPILER == PF_GNU) && defined(__ATOMIC_SEQ_CST)
+    #define PF_ATOMIC_API PF_ATOMIC_GNU
+  #elif (PF_COMPILER == PF_GNU) && (PF_COMPILER_VER >= 401)
+    #define PF_ATOMIC_API PF_ATOMIC_GNU_SYNC
+  #elif (PF_COMPILER == PF_MICROSOFT) && (PF_COMPILER_VER >= 1400)
+    #define PF_ATOMIC_API PF_ATOMIC_MICROSOFT
+  #elif defined(__cplusplus) && (__cplusplus >= 201103L)
+    #define PF_ATOMIC_API PF_ATOMIC_CPP11
+  #else
+    #define PF_ATOMIC_API PF_ATOMIC_NONE
+  #endif
+#endif
+
+// Memory orders (numbered as GCC numbers them, so that they can be passed straight through)
+
+#define PF_MEMORY_ORDER_RELAXED 0
+#define PF_MEMORY_ORDER_ACQUIRE 2
+#define PF_MEMORY_ORDER_RELEASE 3
+#define PF_MEMORY_ORDER_ACQ_REL 4
+#define PF_MEMORY_ORDER_SEQ_CST 5
+
+#if (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT)
+  #include <intrin.h>
+#elif (PF_ATOMIC_API == PF_ATOMIC_CPP11)
+  #include <atomic>
+#endif
+
+// ============================================================================================
+// TYPE DEFINITIONS
+// ============================================================================================
+
+#if (PF_ATOMIC_API == PF_ATOMIC_CPP11)
+
+  typedef std::atomic<int32_t> pf_atomic32_t;
+  typedef std::atomic<int64_t> pf_atomic64_t;
+  typedef std::atomic<void*>   pf_atomic_ptr_t;
+
+#elif (PF_COMPILER == PF_GNU)
+
+  // 64-bit integers are only 4-byte aligned on the 32-bit x86, which isn't enough for them to
+  // be accessed atomically
+
+  typedef volatile int32_t pf_atomic32_t;
+  typedef volatile int64_t pf_atomic64_t __attribute__((aligned(8)));
+  typedef void* volatile   pf_atomic_ptr_t;
+
+#else
+
+  typedef volatile int32_t pf_atomic32_t;
+  typedef volatile int64_t pf_atomic64_t;
+  typedef void* volatile   pf_atomic_ptr_t;
+
+#endif
+
+// ============================================================================================
+// INLINE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+PF_INLINE void pf_compiler_barrier(void)
+{
+  #if (PF_ATOMIC_API == PF_ATOMIC_GNU)
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+  #elif (PF_COMPILER == PF_GNU)
+    __asm__ __volatile__("" : : : "memory");
+  #elif (PF_COMPILER == PF_MICROSOFT)
+    _ReadWriteBarrier();
+  #elif (PF_ATOMIC_API == PF_ATOMIC_CPP11)
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  #endif
+}
+
+/*********************************************************************************************/
+
+PF_INLINE void pf_fence_acquire(void)
+{
+  #if (PF_ATOMIC_API == PF_ATOMIC_GNU)
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  #elif (PF_ATOMIC_API == PF_ATOMIC_GNU_SYNC)
+    __sync_synchronize();
+  #elif (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT) && defined(_M_ARM64)
+    __dmb(_ARM64_BARRIER_ISH);
+  #elif (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT) && defined(_M_ARM)
+    __dmb(_ARM_BARRIER_ISH);
+  #elif (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT)
+    _ReadWriteBarrier();                        // the x86 never reorders loads with each other
+  #elif (PF_ATOMIC_API == PF_ATOMIC_CPP11)
+    std::atomic_thread_fence(std::memory_order_acquire);
+  #endif
+}
+
+/*********************************************************************************************/
+
+PF_INLINE void pf_fence_release(void)
+{
+  #if (PF_ATOMIC_API == PF_ATOMIC_GNU)
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+  #elif (PF_ATOMIC_API == PF_ATOMIC_GNU_SYNC)
+    __sync_synchronize();
+  #elif (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT) && defined(_M_ARM64)
+    __dmb(_ARM64_BARRIER_ISH);
+  #elif (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT) && defined(_M_ARM)
+    __dmb(_ARM_BARRIER_ISH);
+  #elif (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT)
+    _ReadWriteBarrier();                       // the x86 never reorders stores with each other
+  #elif (PF_ATOMIC_API == PF_ATOMIC_CPP11)
+    std::atomic_thread_fence(std::memory_order_release);
+  #endif
+}
+
+/*********************************************************************************************/
+
+PF_INLINE void pf_fence_seq_cst(void)
+{
+  #if (PF_ATOMIC_API == PF_ATOMIC_GNU)
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  #elif (PF_ATOMIC_API == PF_ATOMIC_GNU_SYNC)
+    __sync_synchronize();
+  #elif (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT) && defined(_M_ARM64)
+    __dmb(_ARM64_BARRIER_ISH);
+  #elif (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT) && defined(_M_ARM)
+    __dmb(_ARM_BARRIER_ISH);
+  #elif (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT) && (defined(_M_X64) || defined(_M_AMD64))
+    __faststorefence();
+  #elif (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT)
+    long barrier = 0;                      // a locked instruction is a full barrier on the x86
+
+    _InterlockedOr(&barrier, 0);
+  #elif (PF_ATOMIC_API == PF_ATOMIC_CPP11)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  #endif
+}
+
+/*
+The rest of the functions are defined by the macros below (except with Microsoft's compiler,
+whose intrinsic functions are different for each width).  Each use of one defines the
+functions for one type; "suffix" is the end of their names, "type" is the type of the values
+and "atomic" is the atomic type.
+*/
+
+#if (PF_ATOMIC_API == PF_ATOMIC_GNU)
+
+  /*
+  A load (including a failed compare-and-swap) can't have release semantics and a store can't
+  have acquire semantics.
+  */
+
+  PF_INLINE int pf_atomic_load_order(const int order)
+  {
+    return (order == PF_MEMORY_ORDER_ACQ_REL) ? PF_MEMORY_ORDER_ACQUIRE :
+           (order == PF_MEMORY_ORDER_RELEASE) ? PF_MEMORY_ORDER_RELAXED : order;
+  }
+
+  PF_INLINE int pf_atomic_store_order(const int order)
+  {
+    return (order == PF_MEMORY_ORDER_ACQ_REL) ? PF_MEMORY_ORDER_RELEASE :
+           (order == PF_MEMORY_ORDER_ACQUIRE) ? PF_MEMORY_ORDER_RELAXED : order;
+  }
+
+  #define PF_ATOMIC_FUNCTIONS(suffix, type, atomic)                                           \
+                                                                                              \
+    PF_INLINE type pf_atomic_load##suffix(const atomic* object, const int order)              \
+    {                                                                                         \
+      return __atomic_load_n(object, pf_atomic_load_order(order));                            \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE void pf_atomic_store##suffix(atomic* object, type const value, const int order) \
+    {                                                                                         \
+      __atomic_store_n(object, value, pf_atomic_store_order(order));                          \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE type pf_atomic_exchange##suffix(atomic* object, type const value,               \
+                                              const int order)                                \
+    {                                                                                         \
+      return __atomic_exchange_n(object, value, order);                                       \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE int pf_atomic_cas##suffix(atomic* object, type* expected, type const desired,   \
+                                        const int order)                                      \
+    {                                                                                         \
+      return __atomic_compare_exchange_n(object, expected, desired, 0, order,                 \
+                                         pf_atomic_load_order(order));                        \
+    }
+
+  #define PF_ATOMIC_ARITHMETIC(suffix, type, atomic)                                          \
+                                                                                              \
+    PF_INLINE type pf_atomic_fetch_add##suffix(atomic* object, type const delta,              \
+                                               const int order)                               \
+    {                                                                                         \
+      return __atomic_fetch_add(object, delta, order);                                        \
+    }
+
+#elif (PF_ATOMIC_API == PF_ATOMIC_GNU_SYNC)
+
+  /*
+  The "__sync_...()" functions are always full barriers, so "order" is only used to skip them
+  where an ordinary (relaxed) access is enough.  Values wider than a pointer can't be read or
+  written atomically with ordinary instructions, so they're accessed with compare-and-swap.
+  */
+
+  #define PF_ATOMIC_FUNCTIONS(suffix, type, atomic)                                           \
+                                                                                              \
+    PF_INLINE type pf_atomic_load##suffix(const atomic* object, const int order)              \
+    {                                                                                         \
+      if ((order == PF_MEMORY_ORDER_RELAXED) && (sizeof(type) <= sizeof(void*)))              \
+        return *object;                                                                       \
+                                                                                              \
+      return __sync_val_compare_and_swap((atomic*)object, (type)0, (type)0);                  \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE type pf_atomic_exchange##suffix(atomic* object, type const value,               \
+                                              const int order)                                \
+    {                                                                                         \
+      type previous = *object;                                                                \
+                                                                                              \
+      (void)order;                                                                            \
+                                                                                              \
+      while (!__sync_bool_compare_and_swap(object, previous, value))                          \
+        previous = *object;                                                                   \
+                                                                                              \
+      return previous;                                                                        \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE void pf_atomic_store##suffix(atomic* object, type const value, const int order) \
+    {                                                                                         \
+      if ((order == PF_MEMORY_ORDER_RELAXED) && (sizeof(type) <= sizeof(void*)))              \
+        *object = value;                                                                      \
+      else                                                                                    \
+        pf_atomic_exchange##suffix(object, value, order);                                     \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE int pf_atomic_cas##suffix(atomic* object, type* expected, type const desired,   \
+                                        const int order)                                      \
+    {                                                                                         \
+      type const previous = __sync_val_compare_and_swap(object, *expected, desired);          \
+                                                                                              \
+      (void)order;                                                                            \
+                                                                                              \
+      if (previous == *expected)                                                              \
+        return 1;                                                                             \
+                                                                                              \
+      *expected = previous;                                                                   \
+      return 0;                                                                               \
+    }
+
+  #define PF_ATOMIC_ARITHMETIC(suffix, type, atomic)                                          \
+                                                                                              \
+    PF_INLINE type pf_atomic_fetch_add##suffix(atomic* object, type const delta,              \
+                                               const int order)                               \
+    {                                                                                         \
+      (void)order;                                                                            \
+      return __sync_fetch_and_add(object, delta);                                             \
+    }
+
+#elif (PF_ATOMIC_API == PF_ATOMIC_CPP11)
+
+  PF_INLINE std::memory_order pf_atomic_std_order(const int order)
+  {
+    switch (order)
+    {
+      case PF_MEMORY_ORDER_RELAXED: return std::memory_order_relaxed;
+      case PF_MEMORY_ORDER_ACQUIRE: return std::memory_order_acquire;
+      case PF_MEMORY_ORDER_RELEASE: return std::memory_order_release;
+      case PF_MEMORY_ORDER_ACQ_REL: return std::memory_order_acq_rel;
+      default:                      return std::memory_order_seq_cst;
+    }
+  }
+
+  PF_INLINE std::memory_order pf_atomic_load_order(const int order)
+  {
+    return (order == PF_MEMORY_ORDER_ACQ_REL) ? std::memory_order_acquire :
+           (order == PF_MEMORY_ORDER_RELEASE) ? std::memory_order_relaxed :
+                                                pf_atomic_std_order(order);
+  }
+
+  PF_INLINE std::memory_order pf_atomic_store_order(const int order)
+  {
+    return (order == PF_MEMORY_ORDER_ACQ_REL) ? std::memory_order_release :
+           (order == PF_MEMORY_ORDER_ACQUIRE) ? std::memory_order_relaxed :
+                                                pf_atomic_std_order(order);
+  }
+
+  #define PF_ATOMIC_FUNCTIONS(suffix, type, atomic)                                           \
+                                                                                              \
+    PF_INLINE type pf_atomic_load##suffix(const atomic* object, const int order)              \
+    {                                                                                         \
+      return object->load(pf_atomic_load_order(order));                                       \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE void pf_atomic_store##suffix(atomic* object, type const value, const int order) \
+    {                                                                                         \
+      object->store(value, pf_atomic_store_order(order));                                     \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE type pf_atomic_exchange##suffix(atomic* object, type const value,               \
+                                              const int order)                                \
+    {                                                                                         \
+      return object->exchange(value, pf_atomic_std_order(order));                             \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE int pf_atomic_cas##suffix(atomic* object, type* expected, type const desired,   \
+                                        const int order)                                      \
+    {                                                                                         \
+      return object->compare_exchange_strong(*expected, desired, pf_atomic_std_order(order),  \
+                                             pf_atomic_load_order(order));                    \
+    }
+
+  #define PF_ATOMIC_ARITHMETIC(suffix, type, atomic)                                          \
+                                                                                              \
+    PF_INLINE type pf_atomic_fetch_add##suffix(atomic* object, type const delta,              \
+                                               const int order)                               \
+    {                                                                                         \
+      return object->fetch_add(delta, pf_atomic_std_order(order));                            \
+    }
+
+#elif (PF_ATOMIC_API == PF_ATOMIC_NONE)
+
+  #define PF_ATOMIC_FUNCTIONS(suffix, type, atomic)                                           \
+                                                                                              \
+    PF_INLINE type pf_atomic_load##suffix(const atomic* object, const int order)              \
+    {                                                                                         \
+      (void)order;                                                                            \
+      return *object;                                                                         \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE void pf_atomic_store##suffix(atomic* object, type const value, const int order) \
+    {                                                                                         \
+      (void)order;                                                                            \
+      *object = value;                                                                        \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE type pf_atomic_exchange##suffix(atomic* object, type const value,               \
+                                              const int order)                                \
+    {                                                                                         \
+      type const previous = *object;                                                          \
+                                                                                              \
+      (void)order;                                                                            \
+      *object = value;                                                                        \
+      return previous;                                                                        \
+    }                                                                                         \
+                                                                                              \
+    PF_INLINE int pf_atomic_cas##suffix(atomic* object, type* expected, type const desired,   \
+                                        const int order)                                      \
+    {                                                                                         \
+      (void)order;                                                                            \
+                                                                                              \
+      if (*object != *expected)                                                               \
+      {                                                                                       \
+        *expected = *object;                                                                  \
+        return 0;                                                                             \
+      }                                                                                       \
+                                                                                              \
+      *object = desired;                                                                      \
+      return 1;                                                                               \
+    }
+
+  #define PF_ATOMIC_ARITHMETIC(suffix, type, atomic)                                          \
+                                                                                              \
+    PF_INLINE type pf_atomic_fetch_add##suffix(atomic* object, type const delta,              \
+                                               const int order)                               \
+    {                                                                                         \
+      type const previous = *object;                                                          \
+                                                                                              \
+      (void)order;                                                                            \
+      *object = previous + delta;                                                             \
+      return previous;                                                                        \
+    }
+
+#endif
+
+#ifdef PF_ATOMIC_FUNCTIONS
+
+  PF_ATOMIC_FUNCTIONS(32, int32_t, pf_atomic32_t)
+  PF_ATOMIC_FUNCTIONS(64, int64_t, pf_atomic64_t)
+  PF_ATOMIC_FUNCTIONS(_ptr, void*, pf_atomic_ptr_t)
+  PF_ATOMIC_ARITHMETIC(32, int32_t, pf_atomic32_t)
+  PF_ATOMIC_ARITHMETIC(64, int64_t, pf_atomic64_t)
+
+  #undef PF_ATOMIC_FUNCTIONS
+  #undef PF_ATOMIC_ARITHMETIC
+
+#elif (PF_ATOMIC_API == PF_ATOMIC_MICROSOFT)
+
+  /*
+  The "_Interlocked...()" functions are full barriers.  Ordinary loads and stores of "volatile"
+  variables no wider than a pointer are atomic, so loads and stores only need fences (and
+  sequentially consistent stores are exchanges).  The 32-bit x86 can only access 64-bit values
+  atomically with compare-and-swap.
+  */
+
+  #if defined(_M_IX86)
+    #define PF_ATOMIC_WIDE_CAS_ONLY
+  #endif
+
+  /*******************************************************************************************/
+
+  PF_INLINE int32_t pf_atomic_load32(const pf_atomic32_t* object, const int order)
+  {
+    const int32_t value = *object;
+
+    if (order != PF_MEMORY_ORDER_RELAXED)
+      pf_fence_acquire();
+
+    return value;
+  }
+
+  PF_INLINE int32_t pf_atomic_exchange32(pf_atomic32_t* object, const int32_t value,
+                                         const int order)
+  {
+    (void)order;
+    return _InterlockedExchange((volatile long*)object, value);
+  }
+
+  PF_INLINE void pf_atomic_store32(pf_atomic32_t* object, const int32_t value, const int order)
+  {
+    if (order == PF_MEMORY_ORDER_SEQ_CST)
+      pf_atomic_exchange32(object, value, order);
+    else
+    {
+      if (order != PF_MEMORY_ORDER_RELAXED)
+        pf_fence_release();
+
+      *object = value;
+    }
+  }
+
+  PF_INLINE int pf_atomic_cas32(pf_atomic32_t* object, int32_t* expected,
+                                const int32_t desired, const int order)
+  {
+    const int32_t previous = _InterlockedCompareExchange((volatile long*)object, desired,
+                                                         *expected);
+
+    (void)order;
+
+    if (previous == *expected)
+      return 1;
+
+    *expected = previous;
+    return 0;
+  }
+
+  PF_INLINE int32_t pf_atomic_fetch_add32(pf_atomic32_t* object, const int32_t delta,
+                                          const int order)
+  {
+    (void)order;
+    return _InterlockedExchangeAdd((volatile long*)object, delta);
+  }
+
+  /*******************************************************************************************/
+
+  PF_INLINE int pf_atomic_cas64(pf_atomic64_t* object, int64_t* expected,
+                                const int64_t desired, const int order)
+  {
+    const int64_t previous = _InterlockedCompareExchange64((volatile __int64*)object, desired,
+                                                           *expected);
+
+    (void)order;
+
+    if (previous == *expected)
+      return 1;
+
+    *expected = previous;
+    return 0;
+  }
+
+  PF_INLINE int64_t pf_atomic_load64(const pf_atomic64_t* object, const int order)
+  {
+    #ifdef PF_ATOMIC_WIDE_CAS_ONLY
+      (void)order;
+      return _InterlockedCompareExchange64((volatile __int64*)object, 0, 0);
+    #else
+      const int64_t value = *object;
+
+      if (order != PF_MEMORY_ORDER_RELAXED)
+        pf_fence_acquire();
+
+      return value;
+    #endif
+  }
+
+  PF_INLINE int64_t pf_atomic_exchange64(pf_atomic64_t* object, const int64_t value,
+                                         const int order)
+  {
+    #ifdef PF_ATOMIC_WIDE_CAS_ONLY
+      int64_t previous = *object;
+
+      while (!pf_atomic_cas64(object, &previous, value, order))
+        ;
+
+      return previous;
+    #else
+      (void)order;
+      return _InterlockedExchange64((volatile __int64*)object, value);
+    #endif
+  }
+
+  PF_INLINE void pf_atomic_store64(pf_atomic64_t* object, const int64_t value, const int order)
+  {
+    #ifdef PF_ATOMIC_WIDE_CAS_ONLY
+      pf_atomic_exchange64(object, value, order);
+    #else
+      if (order == PF_MEMORY_ORDER_SEQ_CST)
+        pf_atomic_exchange64(object, value, order);
+      else
+      {
+        if (order != PF_MEMORY_ORDER_RELAXED)
+          pf_fence_release();
+
+        *object = value;
+      }
+    #endif
+  }
+
+  PF_INLINE int64_t pf_atomic_fetch_add64(pf_atomic64_t* object, const int64_t delta,
+                                          const int order)
+  {
+    #ifdef PF_ATOMIC_WIDE_CAS_ONLY
+      int64_t previous = *object;
+
+      while (!pf_atomic_cas64(object, &previous, previous + delta, order))
+        ;
+
+      return previous;
+    #else
+      (void)order;
+      return _InterlockedExchangeAdd64((volatile __int64*)object, delta);
+    #endif
+  }
+
+  /*******************************************************************************************/
+
+  PF_INLINE void* pf_atomic_load_ptr(const pf_atomic_ptr_t* object, const int order)
+  {
+    void* const value = *object;
+
+    if (order != PF_MEMORY_ORDER_RELAXED)
+      pf_fence_acquire();
+
+    return value;
+  }
+
+  PF_INLINE void* pf_atomic_exchange_ptr(pf_atomic_ptr_t* object, void* const value,
+                                         const int order)
+  {
+    (void)order;
+    return _InterlockedExchangePointer((void* volatile*)object, value);
+  }
+
+  PF_INLINE void pf_atomic_store_ptr(pf_atomic_ptr_t* object, void* const value,
+                                     const int order)
+  {
+    if (order == PF_MEMORY_ORDER_SEQ_CST)
+      pf_atomic_exchange_ptr(object, value, order);
+    else
+    {
+      if (order != PF_MEMORY_ORDER_RELAXED)
+        pf_fence_release();
+
+      *object = value;
+    }
+  }
+
+  PF_INLINE int pf_atomic_cas_ptr(pf_atomic_ptr_t* object, void** expected,
+                                  void* const desired, const int order)
+  {
+    void* const previous = _InterlockedCompareExchangePointer((void* volatile*)object, desired,
+                                                              *expected);
+
+    (void)order;
+
+    if (previous == *expected)
+      return 1;
+
+    *expected = previous;
+    return 0;
+  }
+
+  #undef PF_ATOMIC_WIDE_CAS_ONLY
+
+#endif
+
+#endif
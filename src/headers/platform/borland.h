@@ -296,6 +296,7 @@ The following was taken from the help files of Borland C++ Builder 5.0 for Windo
   #endif
 
   #define PF_CPU            PF_INTEL_X86
+  #define PF_ENDIAN         PF_ENDIAN_LITTLE
 
   #if (defined(_Windows) || defined(__OS2__))
     #define PF_STD_LIB_CALL _USERENTRY
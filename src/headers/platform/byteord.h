@@ -0,0 +1,385 @@
+#ifndef PLATFORM_BYTEORD_H
+#define PLATFORM_BYTEORD_H
+
+// ============================================================================================
+//
+// byteord.h -- Byte Order Conversion
+//
+// ============================================================================================
+
+/*
+This header file defines inline functions that reverse the order of an integer's bytes, and
+that load and store integers in a particular byte order whatever the CPU's byte order is:
+
+  uint16_t pf_bswap16(uint16_t value)
+  uint32_t pf_bswap32(uint32_t value)
+  uint64_t pf_bswap64(uint64_t value)
+
+  uint16_t pf_load_le16(const void* source)  void pf_store_le16(void* target, uint16_t value)
+  uint32_t pf_load_le32(const void* source)  void pf_store_le32(void* target, uint32_t value)
+  uint64_t pf_load_le64(const void* source)  void pf_store_le64(void* target, uint64_t value)
+  uint16_t pf_load_be16(const void* source)  void pf_store_be16(void* target, uint16_t value)
+  uint32_t pf_load_be32(const void* source)  void pf_store_be32(void* target, uint32_t value)
+  uint64_t pf_load_be64(const void* source)  void pf_store_be64(void* target, uint64_t value)
+
+"source" and "target" needn't be aligned.  Where "PF_ENDIAN" is known and the compiler has a
+built-in byte order reversal function ("PF_BSWAP16()", etc., defined by the compiler's header
+file), each of these compiles to a load or store plus, if the byte order is the opposite of the
+CPU's, one reversal instruction (which the compiler will often merge into the load or store --
+"movbe" on the x86, for example).  Where "PF_ENDIAN" is "PF_ENDIAN_UNKNOWN" the bytes are
+assembled one at a time, which is always correct but much slower.
+
+Each function also has a variant that converts an array:
+
+  void pf_bswap16_array(void* target, const void* source, size_t count)
+  void pf_load_le16_array(uint16_t* target, const void* source, size_t count)
+  void pf_store_le16_array(void* target, const uint16_t* source, size_t count)
+
+and so on for the other widths and byte orders.  "count" is the number of integers (not bytes).
+The arrays are processed 16 bytes at a time using SSSE3 ("pshufb"), SSE2 or NEON ("vrev")
+instructions where the compiler can generate them.  "target" and "source" may be the same (to
+convert an array in place) but mustn't otherwise overlap.
+
+"PF_ENDIAN_RUNTIME" is the byte order that the CPU is actually using, determined while the
+program is running.  Comparing it with "PF_ENDIAN" catches a mis-configured (cross-)compiler:
+
+  assert((PF_ENDIAN == PF_ENDIAN_UNKNOWN) || (PF_ENDIAN == PF_ENDIAN_RUNTIME));
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <platform.h>
+
+#if PF_SIMD_SSSE3
+  #include <tmmintrin.h>
+#elif PF_SIMD_SSE2
+  #include <emmintrin.h>
+#elif PF_SIMD_NEON
+  #include <arm_neon.h>
+#endif
+
+// ============================================================================================
+// MACRO DEFINITIONS
+// ============================================================================================
+
+#define PF_ENDIAN_RUNTIME pf_endian_runtime()
+
+// ============================================================================================
+// INLINE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+PF_INLINE int pf_endian_runtime(void)
+
+/*
+This function determines the CPU's byte order by looking at how an integer is stored.
+
+POSTCONDITIONS:
+"PF_ENDIAN_LITTLE" or "PF_ENDIAN_BIG" is returned ("PF_ENDIAN_UNKNOWN" if the CPU stores
+integers some other way, as the PDP-11 did).
+*/
+
+{
+  const uint32_t probe = 0x01020304UL;
+  unsigned char  bytes[sizeof(probe)];
+
+  memcpy(bytes, &probe, sizeof(probe));
+
+  if ((bytes[0] == 4) && (bytes[1] == 3) && (bytes[2] == 2) && (bytes[3] == 1))
+    return PF_ENDIAN_LITTLE;
+  else if ((bytes[0] == 1) && (bytes[1] == 2) && (bytes[2] == 3) && (bytes[3] == 4))
+    return PF_ENDIAN_BIG;
+  else
+    return PF_ENDIAN_UNKNOWN;
+}
+
+/*********************************************************************************************/
+
+PF_INLINE uint16_t pf_bswap16(const uint16_t value)
+{
+  #ifdef PF_BSWAP16
+    return PF_BSWAP16(value);
+  #else
+    return (uint16_t)((value >> 8) | (value << 8));
+  #endif
+}
+
+/*********************************************************************************************/
+
+PF_INLINE uint32_t pf_bswap32(const uint32_t value)
+{
+  #ifdef PF_BSWAP32
+    return PF_BSWAP32(value);
+  #else
+    return ((value >> 24) & 0x000000ffUL) | ((value >>  8) & 0x0000ff00UL) |
+           ((value <<  8) & 0x00ff0000UL) | ((value << 24) & 0xff000000UL);
+  #endif
+}
+
+/*********************************************************************************************/
+
+PF_INLINE uint64_t pf_bswap64(const uint64_t value)
+{
+  #ifdef PF_BSWAP64
+    return PF_BSWAP64(value);
+  #else
+    return ((uint64_t)pf_bswap32((uint32_t)value) << 32) | pf_bswap32((uint32_t)(value >> 32));
+  #endif
+}
+
+/*********************************************************************************************/
+
+PF_INLINE uint64_t pf_byteord_get
+(
+  const void* source,                                        // where the integer is stored
+  const int   size,                                           // the integer's size in bytes
+  const int   bigEndian                                // non-zero if stored most significant
+)                                                      // byte first
+
+/*
+This function assembles an integer one byte at a time.  It's used when "PF_ENDIAN" isn't known.
+*/
+
+{
+  const unsigned char* bytes  = (const unsigned char*)source;
+  uint64_t             result = 0;
+  int                  i;
+
+  for (i = 0; i < size; i++)
+    result |= (uint64_t)bytes[i] << (8 * (bigEndian ? size - 1 - i : i));
+
+  return result;
+}
+
+/*********************************************************************************************/
+
+PF_INLINE void pf_byteord_put
+(
+  void*          target,                                  // where to store the integer
+  const uint64_t value,                                                // the integer to store
+  const int      size,                                        // the integer's size in bytes
+  const int      bigEndian                             // non-zero to store most significant
+)                                                      // byte first
+
+/*
+This function stores an integer one byte at a time.  It's used when "PF_ENDIAN" isn't known.
+*/
+
+{
+  unsigned char* bytes = (unsigned char*)target;
+  int            i;
+
+  for (i = 0; i < size; i++)
+    bytes[i] = (unsigned char)(value >> (8 * (bigEndian ? size - 1 - i : i)));
+}
+
+/*********************************************************************************************/
+
+PF_INLINE void pf_bswap16_array(void* target, const void* source, const size_t count)
+{
+  unsigned char*       to   = (unsigned char*)target;
+  const unsigned char* from = (const unsigned char*)source;
+  size_t               i    = 0;
+
+  #if PF_SIMD_SSSE3
+    const __m128i order = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m128i values = _mm_loadu_si128((const __m128i*)(from + i * 2));
+
+      _mm_storeu_si128((__m128i*)(to + i * 2), _mm_shuffle_epi8(values, order));
+    }
+  #elif PF_SIMD_SSE2
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m128i values = _mm_loadu_si128((const __m128i*)(from + i * 2));
+
+      _mm_storeu_si128((__m128i*)(to + i * 2),
+                       _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8)));
+    }
+  #elif PF_SIMD_NEON
+    for (; i + 8 <= count; i += 8)
+      vst1q_u8(to + i * 2, vrev16q_u8(vld1q_u8(from + i * 2)));
+  #endif
+
+  for (; i < count; i++)
+  {
+    uint16_t value;
+
+    memcpy(&value, from + i * 2, sizeof(value));
+    value = pf_bswap16(value);
+    memcpy(to + i * 2, &value, sizeof(value));
+  }
+}
+
+/*********************************************************************************************/
+
+PF_INLINE void pf_bswap32_array(void* target, const void* source, const size_t count)
+{
+  unsigned char*       to   = (unsigned char*)target;
+  const unsigned char* from = (const unsigned char*)source;
+  size_t               i    = 0;
+
+  #if PF_SIMD_SSSE3
+    const __m128i order = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m128i values = _mm_loadu_si128((const __m128i*)(from + i * 4));
+
+      _mm_storeu_si128((__m128i*)(to + i * 4), _mm_shuffle_epi8(values, order));
+    }
+  #elif PF_SIMD_SSE2
+    // Swap the 16-bit halves of each integer, then the bytes of each half.
+
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128i values = _mm_loadu_si128((const __m128i*)(from + i * 4));
+
+      values = _mm_shufflelo_epi16(values, _MM_SHUFFLE(2, 3, 0, 1));
+      values = _mm_shufflehi_epi16(values, _MM_SHUFFLE(2, 3, 0, 1));
+      _mm_storeu_si128((__m128i*)(to + i * 4),
+                       _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8)));
+    }
+  #elif PF_SIMD_NEON
+    for (; i + 4 <= count; i += 4)
+      vst1q_u8(to + i * 4, vrev32q_u8(vld1q_u8(from + i * 4)));
+  #endif
+
+  for (; i < count; i++)
+  {
+    uint32_t value;
+
+    memcpy(&value, from + i * 4, sizeof(value));
+    value = pf_bswap32(value);
+    memcpy(to + i * 4, &value, sizeof(value));
+  }
+}
+
+/*********************************************************************************************/
+
+PF_INLINE void pf_bswap64_array(void* target, const void* source, const size_t count)
+{
+  unsigned char*       to   = (unsigned char*)target;
+  const unsigned char* from = (const unsigned char*)source;
+  size_t               i    = 0;
+
+  #if PF_SIMD_SSSE3
+    const __m128i order = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+    for (; i + 2 <= count; i += 2)
+    {
+      const __m128i values = _mm_loadu_si128((const __m128i*)(from + i * 8));
+
+      _mm_storeu_si128((__m128i*)(to + i * 8), _mm_shuffle_epi8(values, order));
+    }
+  #elif PF_SIMD_SSE2
+    // Reverse the 16-bit quarters of each integer, then swap the bytes of each quarter.
+
+    for (; i + 2 <= count; i += 2)
+    {
+      __m128i values = _mm_loadu_si128((const __m128i*)(from + i * 8));
+
+      values = _mm_shufflelo_epi16(values, _MM_SHUFFLE(0, 1, 2, 3));
+      values = _mm_shufflehi_epi16(values, _MM_SHUFFLE(0, 1, 2, 3));
+      _mm_storeu_si128((__m128i*)(to + i * 8),
+                       _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8)));
+    }
+  #elif PF_SIMD_NEON
+    for (; i + 2 <= count; i += 2)
+      vst1q_u8(to + i * 8, vrev64q_u8(vld1q_u8(from + i * 8)));
+  #endif
+
+  for (; i < count; i++)
+  {
+    uint64_t value;
+
+    memcpy(&value, from + i * 8, sizeof(value));
+    value = pf_bswap64(value);
+    memcpy(to + i * 8, &value, sizeof(value));
+  }
+}
+
+// ============================================================================================
+// GENERATED INLINE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*
+Each use of "PF_BYTEORD_FUNCTIONS()" defines the single-integer and array load and store
+functions for one width and byte order.  "native" is non-zero if the byte order is the CPU's,
+"swapped" is non-zero if it's the opposite of the CPU's, and both are zero if "PF_ENDIAN" isn't
+known.  Since both are constants, the compiler discards the branches that aren't taken.
+*/
+
+#define PF_BYTEORD_FUNCTIONS(order, bits, bigEndian, native, swapped)                       \
+                                                                                            \
+  PF_INLINE uint##bits##_t pf_load_##order##bits(const void* source)                        \
+  {                                                                                         \
+    uint##bits##_t value;                                                                   \
+                                                                                            \
+    if (!(native) && !(swapped))                                                            \
+      return (uint##bits##_t)pf_byteord_get(source, (bits) / 8, (bigEndian));               \
+                                                                                            \
+    memcpy(&value, source, sizeof(value));                                                  \
+    return ((swapped) ? pf_bswap##bits(value) : value);                                     \
+  }                                                                                         \
+                                                                                            \
+  PF_INLINE void pf_store_##order##bits(void* target, const uint##bits##_t value)           \
+  {                                                                                         \
+    if (!(native) && !(swapped))                                                            \
+      pf_byteord_put(target, value, (bits) / 8, (bigEndian));                               \
+    else                                                                                    \
+    {                                                                                       \
+      const uint##bits##_t stored = ((swapped) ? pf_bswap##bits(value) : value);            \
+                                                                                            \
+      memcpy(target, &stored, sizeof(stored));                                              \
+    }                                                                                       \
+  }                                                                                         \
+                                                                                            \
+  PF_INLINE void pf_load_##order##bits##_array(uint##bits##_t* target, const void* source,  \
+                                               const size_t count)                          \
+  {                                                                                         \
+    size_t i;                                                                               \
+                                                                                            \
+    if (swapped)                                                                            \
+      pf_bswap##bits##_array(target, source, count);                                        \
+    else if (native)                                                                        \
+      memmove(target, source, count * sizeof(*target));                                     \
+    else                                                                                    \
+      for (i = 0; i < count; i++)                                                           \
+        target[i] = pf_load_##order##bits((const char*)source + i * sizeof(*target));       \
+  }                                                                                         \
+                                                                                            \
+  PF_INLINE void pf_store_##order##bits##_array(void* target, const uint##bits##_t* source, \
+                                                const size_t count)                         \
+  {                                                                                         \
+    size_t i;                                                                               \
+                                                                                            \
+    if (swapped)                                                                            \
+      pf_bswap##bits##_array(target, source, count);                                        \
+    else if (native)                                                                        \
+      memmove(target, source, count * sizeof(*source));                                     \
+    else                                                                                    \
+      for (i = 0; i < count; i++)                                                           \
+        pf_store_##order##bits((char*)target + i * sizeof(*source), source[i]);             \
+  }
+
+PF_BYTEORD_FUNCTIONS(le, 16, 0, PF_ENDIAN == PF_ENDIAN_LITTLE, PF_ENDIAN == PF_ENDIAN_BIG)
+PF_BYTEORD_FUNCTIONS(le, 32, 0, PF_ENDIAN == PF_ENDIAN_LITTLE, PF_ENDIAN == PF_ENDIAN_BIG)
+PF_BYTEORD_FUNCTIONS(le, 64, 0, PF_ENDIAN == PF_ENDIAN_LITTLE, PF_ENDIAN == PF_ENDIAN_BIG)
+PF_BYTEORD_FUNCTIONS(be, 16, 1, PF_ENDIAN == PF_ENDIAN_BIG,    PF_ENDIAN == PF_ENDIAN_LITTLE)
+PF_BYTEORD_FUNCTIONS(be, 32, 1, PF_ENDIAN == PF_ENDIAN_BIG,    PF_ENDIAN == PF_ENDIAN_LITTLE)
+PF_BYTEORD_FUNCTIONS(be, 64, 1, PF_ENDIAN == PF_ENDIAN_BIG,    PF_ENDIAN == PF_ENDIAN_LITTLE)
+
+#undef PF_BYTEORD_FUNCTIONS
+
+#endif
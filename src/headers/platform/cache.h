@@ -0,0 +1,67 @@
+#ifndef PLATFORM_CACHE_H
+#define PLATFORM_CACHE_H
+
+// ============================================================================================
+//
+// cache.h -- Run-Time Cache Topology Query
+//
+// ============================================================================================
+
+/*
+"PF_CACHE_LINE_SIZE" and "PF_PAGE_SIZE" are compile-time estimates.  Code that tiles or blocks
+its data to fit the caches (matrix multiplication and hash joins, for example) will run faster
+if it uses the actual sizes of the caches of the CPU that the program is running on, which can
+be found with the routines declared here:
+
+  #include <platform/cache.h>
+
+  const PfCacheInfo* caches = pf_cache_info();
+  size_t             tile   = caches->level2.size / 2;
+
+  if (tile == 0)
+    tile = 256 * 1024;                                       // the L2 cache size isn't known
+
+The caches are queried once (either during static initialization or on the first call to
+"pf_cache_info()", whichever comes first) and the result is cached.  Where a CPU has cores of
+different kinds (Apple's performance and efficiency cores, for example), the caches of the
+first core are reported.
+
+"src/code/cache.cpp" and "src/code/cpufeat.cpp" must be compiled into the program.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <platform.h>
+
+// ============================================================================================
+// TYPE DEFINITIONS
+// ============================================================================================
+
+typedef struct
+{
+  unsigned long size;                                                    // total size in bytes
+  unsigned long lineSize;                                                 // line size in bytes
+  unsigned long associativity;                       // number of ways (0 if fully associative)
+  unsigned long sharedBy;                                 // number of logical CPU's sharing it
+}
+PfCacheLevel;
+
+typedef struct
+{
+  PfCacheLevel level1Data;
+  PfCacheLevel level1Instruction;
+  PfCacheLevel level2;                                           // unified (or data, if split)
+  PfCacheLevel level3;                                           // unified (or data, if split)
+}
+PfCacheInfo;
+
+// ============================================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================================
+
+const PfCacheInfo* pf_cache_info(void);
+unsigned long      pf_page_size(void);
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef PLATFORM_COUNTER_H
+#define PLATFORM_COUNTER_H
+
+// ============================================================================================
+//
+// counter.h -- Sharded Statistics Counters
+//
+// ============================================================================================
+
+/*
+A counter that many threads add to (a statistic such as the number of requests served, for
+example) is a poor fit for a single atomic integer:  every increment has to take the
+integer's cache line away from whichever CPU last wrote to it, so the more threads there are,
+the slower each increment gets.  A "pf::sharded_counter" keeps a number of separate counts
+("shards"), each on a cache line of its own, and each thread adds to the shard that it was
+assigned the first time it used one.  Reading the counter adds up all the shards:
+
+  #include <platform/counter.h>
+
+  static pf::sharded_counter requests;                       // one shard per CPU
+
+  requests.add();                                            // or "requests.add(count)"
+  ...
+  printf("%lld requests\n", (long long)requests.value());
+
+Threads are assigned shards in turn, so a process with no more threads than shards gives each
+thread a shard of its own and adding never moves a cache line between CPUs.  With more threads
+than that, some threads share a shard, which is still correct (adding is a relaxed atomic
+operation) but a little slower.  Without thread-local variables (see "PF_THREAD_LOCAL" in
+<platform.h>), a shard is chosen by hashing the address of the thread's stack instead.
+
+"value()" isn't a snapshot:  additions that happen while it's adding up the shards may or may
+not be included.  For the same reason, "reset()" should only be called when nothing else is
+adding to the counter.  The total is a 64-bit integer; subtracting (adding a negative amount)
+is allowed, but an individual shard can then be negative.
+
+The number of shards is rounded up to a power of 2.  By default it's the number of CPUs that
+the program can use (see <platform/affinity.h>).  If the shards can't be allocated, the
+counter works with a single shard of its own.
+
+"src/code/counter.cpp", "src/code/affinity.cpp" and "src/code/alloc.cpp" must be compiled into
+the program.
+
+NOTE:  This header file requires a C++ compiler that supports namespaces and templates.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <platform.h>
+#include <platform/align.h>
+#include <platform/atomic.h>
+
+namespace pf
+{
+
+// ============================================================================================
+// CLASS DEFINITIONS
+// ============================================================================================
+
+class sharded_counter
+{
+  public:
+    sharded_counter(const unsigned shards = 0);
+    ~sharded_counter();
+
+    unsigned shards() const {return _mask + 1;}
+
+    void    add(const int64_t amount = 1);
+    int64_t value() const;
+    void    reset();
+
+  private:
+    struct shard
+    {
+      pf_atomic64_t count;                                    // this shard's part of the total
+    };
+
+    padded<shard>* _shards;                                                       // the shards
+    unsigned       _mask;                                       // the number of shards, less 1
+    padded<shard>  _single;                           // the only shard, if "_shards" is unused
+
+    #ifdef PF_THREAD_LOCAL
+      static PF_THREAD_LOCAL PF_TLS_INITIAL_EXEC unsigned _threadShard; // 0 = not assigned yet
+      static pf_atomic32_t                                 _nextShard;    // the next to assign
+    #endif
+
+    static unsigned         threadShard();
+    PF_COLD static unsigned assignShard();
+
+    sharded_counter(const sharded_counter&);                                    // not copyable
+    sharded_counter& operator=(const sharded_counter&);
+};
+
+// ============================================================================================
+// INLINE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+inline unsigned sharded_counter::threadShard()
+
+/*
+This function determines which shard the calling thread should use.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+A number is returned that's the same every time the calling thread calls this function (if
+thread-local variables are available) and usually different for different threads.  Only its
+low bits should be used.
+*/
+
+{
+  #ifdef PF_THREAD_LOCAL
+
+    const unsigned assigned = _threadShard;
+
+    return PF_LIKELY(assigned != 0) ? assigned : assignShard();
+
+  #else
+
+    char   marker;
+    size_t hash = (size_t)&marker >> 16;                  // each thread has a stack of its own
+
+    hash ^= (hash >> 7) ^ (hash >> 13) ^ (hash >> 19);
+    return (unsigned)hash;
+
+  #endif
+}
+
+/*********************************************************************************************/
+
+inline void sharded_counter::add
+(
+  const int64_t amount                                                     // the amount to add
+)
+
+/*
+This function adds to the counter.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+"amount" has been added to the calling thread's shard.
+*/
+
+{
+  pf_atomic_fetch_add64(&_shards[threadShard() & _mask]->count, amount,
+                        PF_MEMORY_ORDER_RELAXED);
+}
+
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef PLATFORM_CPUFEAT_H
+#define PLATFORM_CPUFEAT_H
+
+// ============================================================================================
+//
+// cpufeat.h -- Run-Time CPU Feature Detection
+//
+// ============================================================================================
+
+/*
+"PF_CPU" identifies the CPU family that a program was compiled for, but it can't say which
+instruction set extensions are present on the CPU that the program is actually running on.  A
+program compiled for the lowest common denominator of a CPU family can use the routines
+declared here to find out what the deployment hardware can do and choose the fastest code
+path accordingly.
+
+The CPU is queried once (either during static initialization or on the first call to
+"pf_cpu_features()", whichever comes first) and the result is cached.  Calling
+"pf_cpu_features()" or "pf_cpu_has()" afterwards costs no more than reading a variable.
+
+Features are reported as bits in an "unsigned long" bitmask (at least 32 bits wide on every
+platform).  Bits for different CPU families may overlap in the future, so only test for
+features that belong to the CPU family that the program was compiled for.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <platform.h>
+
+// ============================================================================================
+// FEATURE BIT MACROS
+// ============================================================================================
+
+// Intel x86 and compatible (32- and 64-bit)
+
+#define PF_CPU_FEATURE_SSE       0x00000001UL
+#define PF_CPU_FEATURE_SSE2      0x00000002UL
+#define PF_CPU_FEATURE_SSE3      0x00000004UL
+#define PF_CPU_FEATURE_SSSE3     0x00000008UL
+#define PF_CPU_FEATURE_SSE4_1    0x00000010UL
+#define PF_CPU_FEATURE_SSE4_2    0x00000020UL
+#define PF_CPU_FEATURE_POPCNT    0x00000040UL
+#define PF_CPU_FEATURE_LZCNT     0x00000080UL
+#define PF_CPU_FEATURE_MOVBE     0x00000100UL
+#define PF_CPU_FEATURE_AVX       0x00000200UL
+#define PF_CPU_FEATURE_F16C      0x00000400UL
+#define PF_CPU_FEATURE_FMA       0x00000800UL
+#define PF_CPU_FEATURE_AVX2      0x00001000UL
+#define PF_CPU_FEATURE_BMI1      0x00002000UL
+#define PF_CPU_FEATURE_BMI2      0x00004000UL
+#define PF_CPU_FEATURE_AVX512F   0x00008000UL
+#define PF_CPU_FEATURE_AVX512DQ  0x00010000UL
+#define PF_CPU_FEATURE_AVX512CD  0x00020000UL
+#define PF_CPU_FEATURE_AVX512BW  0x00040000UL
+#define PF_CPU_FEATURE_AVX512VL  0x00080000UL
+
+// ARM (32-bit and AArch64)
+
+#define PF_CPU_FEATURE_NEON      0x00100000UL
+#define PF_CPU_FEATURE_CRC32     0x00200000UL
+#define PF_CPU_FEATURE_AES       0x00400000UL
+#define PF_CPU_FEATURE_SHA2      0x00800000UL
+#define PF_CPU_FEATURE_ATOMICS   0x01000000UL
+#define PF_CPU_FEATURE_DOTPROD   0x02000000UL
+#define PF_CPU_FEATURE_SVE       0x04000000UL
+#define PF_CPU_FEATURE_SVE2      0x08000000UL
+
+// ============================================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================================
+
+unsigned long pf_cpu_features(void);
+int           pf_cpu_has(const unsigned long);
+int           pf_cpuid(const unsigned long, const unsigned long, unsigned long[4]);
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef PLATFORM_DISPATCH_H
+#define PLATFORM_DISPATCH_H
+
+// ============================================================================================
+//
+// dispatch.h -- Load-Time Selection of Instruction-Set-Specific Routines
+//
+// ============================================================================================
+
+/*
+This header file defines macros that declare one logical routine with several bodies, each
+written for a different set of instruction set extensions, and bind the routine to the best
+body for the CPU that the program is running on.  The binding is done once, so calling the
+routine afterwards costs no more than calling it through a function pointer (and, where load-
+time binding is available, no more than any other call into a shared library).
+
+For example:
+
+  #include <platform/dispatch.h>
+
+  static size_t countScalar(const char* text, size_t length, char wanted)
+  {
+    ...
+  }
+
+  #ifdef PF_TARGET_AVX2
+    static PF_TARGET_AVX2 size_t countAvx2(const char* text, size_t length, char wanted)
+    {
+      ...
+    }
+  #endif
+
+  static const PfDispatchEntry countVariants[] =
+  {
+    #ifdef PF_TARGET_AVX2
+      PF_DISPATCH_VARIANT(PF_CPU_FEATURE_AVX2, countAvx2),
+    #endif
+    PF_DISPATCH_DEFAULT(countScalar)
+  };
+
+  PF_DISPATCH(size_t, count, (const char* text, size_t length, char wanted),
+              (text, length, wanted), countVariants)
+
+"count()" can then be declared in a header file and called like any other function.
+
+Variants are tried in order and the first one whose "PF_CPU_FEATURE_..." bits are all
+supported is chosen, so they must be listed from most to least demanding.  The list must end
+with "PF_DISPATCH_DEFAULT()", which is always chosen if nothing else is.
+
+"src/code/cpufeat.cpp" must be linked into the same program or library as the dispatched
+routine.
+
+NOTE:  This header file requires a C++ compiler.
+*/
+
+// ============================================================================================
+// DESIGN NOTES
+// ============================================================================================
+
+/*
+Where the compiler and C library support indirect functions ("PF_IFUNC" is defined by the
+compiler's header file), the routine is declared as one and the dynamic loader calls a
+generated resolver once while relocating the program or library.  No code runs on later calls.
+The resolver runs before static initialization, which is why "pf_cpu_features()" detects the
+CPU's features on demand rather than relying on static initialization.  It can even run before
+the program or library that it's part of has been fully relocated, so "pf_cpu_features()" must
+only execute instructions (CPUID and XGETBV) or make system queries ("getauxval()") that are
+safe that early -- no heap, no standard I/O, no "errno" and no thread-local variables -- and
+must stay that way when features are added.  Define
+"PF_DISPATCH_NO_IFUNC" before including this file to use the portable mechanism instead (for
+example, when linking statically or against a C library that doesn't support indirect
+functions).
+
+Everywhere else the routine calls its body through a function pointer, which is kept in a
+"pf_atomic_ptr_t" (see <platform/atomic.h>) so that threads can read and write it at the same
+time.  The pointer is initially NULL (static zero-initialization, so it doesn't depend on the
+order of static initialization either), and the first call chooses the body and stores it.
+If two threads make the first call at the same time then both make the same choice, so
+nothing is lost.  Relaxed accesses are enough, since the pointer is the only thing shared.
+
+"PF_TARGET_CLONES" (also from the compiler's header file) is a simpler alternative for
+routines that don't use intrinsics: the compiler compiles one body for each listed target and
+selects the best one at load time by itself.  If it isn't supported then the body is compiled
+once, for the default target.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <platform.h>
+#include <platform/atomic.h>
+#include <platform/cpufeat.h>
+
+// ============================================================================================
+// TYPE DEFINITIONS
+// ============================================================================================
+
+typedef void (*PfDispatchRoutine)(void);                 // a body with its type erased
+
+typedef struct
+{
+  unsigned long     features;                  // the "PF_CPU_FEATURE_..." bits that it needs
+  PfDispatchRoutine routine;                                          // the body to call
+}
+PfDispatchEntry;
+
+// ============================================================================================
+// MACRO DEFINITIONS
+// ============================================================================================
+
+#define PF_DISPATCH_VARIANT(features, routine) {(features), (PfDispatchRoutine)(routine)}
+#define PF_DISPATCH_DEFAULT(routine)           {0,          (PfDispatchRoutine)(routine)}
+
+#if defined(PF_IFUNC) && !defined(PF_DISPATCH_NO_IFUNC)
+
+  #define PF_DISPATCH(returnType, name, parameters, arguments, variants)                     \
+    typedef returnType (*name##DispatchType) parameters;                                     \
+    static name##DispatchType name##DispatchResolver(void)                                   \
+      __asm__(#name "DispatchResolver");                                                     \
+    static name##DispatchType name##DispatchResolver(void)                                   \
+    {                                                                                        \
+      return (name##DispatchType)pf_dispatch_select(variants);                               \
+    }                                                                                        \
+    returnType name parameters PF_IFUNC(#name "DispatchResolver");
+
+#else
+
+  #define PF_DISPATCH(returnType, name, parameters, arguments, variants)                     \
+    typedef returnType (*name##DispatchType) parameters;                                     \
+    static pf_atomic_ptr_t name##DispatchPointer;                                            \
+    returnType name parameters                                                               \
+    {                                                                                        \
+      name##DispatchType routine = (name##DispatchType)                                      \
+        pf_atomic_load_ptr(&name##DispatchPointer, PF_MEMORY_ORDER_RELAXED);                 \
+                                                                                             \
+      if (PF_UNLIKELY(routine == NULL))                                                      \
+      {                                                                                      \
+        routine = (name##DispatchType)pf_dispatch_select(variants);                          \
+        pf_atomic_store_ptr(&name##DispatchPointer, (void*)routine,                          \
+                            PF_MEMORY_ORDER_RELAXED);                                        \
+      }                                                                                      \
+                                                                                             \
+      return routine arguments;                                                              \
+    }
+
+#endif
+
+// ============================================================================================
+// INLINE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+inline PfDispatchRoutine pf_dispatch_select
+(
+  const PfDispatchEntry* variants                     // the variants, most demanding first
+)
+
+/*
+This function chooses the first variant whose instruction set extensions are all supported by
+the CPU that the program is running on.
+
+PRECONDITIONS:
+"variants" must end with an entry that needs no features ("PF_DISPATCH_DEFAULT()").
+
+POSTCONDITIONS:
+The chosen variant's routine is returned.
+*/
+
+{
+  const unsigned long available = pf_cpu_features();
+
+  while ((variants->features & available) != variants->features)
+    variants++;
+
+  return variants->routine;
+}
+
+#endif
@@ -4,7 +4,7 @@
 //
 // ============================================================================================
 
-#ifndef PLATFORM_H
+#ifndef PF_GNU
   #error platform.h has not been included yet.
 #endif
 
@@ -118,41 +118,545 @@ The following was taken from the GNU C online help pages:
 
   __sequent__            `__sequent__' is predefined on all models of Sequent computers.
 
+The following was summarized from the online manuals for more recent versions of GCC and Clang:
+
+  __i386__               Predefined when compiling for a 32-bit x86 CPU.
+
+  __x86_64__             Predefined when compiling for an x86-64 (AMD64 or Intel 64) CPU.
+
+  __SSE4_2__, __POPCNT__,
+  __AVX2__, __BMI2__,    Predefined when the corresponding instruction set extension has been
+  __FMA__, __AVX512F__,  enabled (by "-m..." or "-march=..." options).  Together they
+  __AVX512BW__, etc.     indicate which x86-64 micro-architecture level is being targeted.
+
+  __arm__                Predefined when compiling for a 32-bit ARM CPU.
+
+  __aarch64__            Predefined when compiling for a 64-bit ARM (AArch64) CPU.
+
+  __ARM_ARCH             The ARM architecture version being targeted (for example, 7 or 8).
+
+  __powerpc__            Predefined when compiling for a 32- or 64-bit PowerPC CPU.
+
+  __powerpc64__          Predefined when compiling for a 64-bit PowerPC or POWER CPU.
+
+  _ARCH_PWR7, _ARCH_PWR8,
+  _ARCH_PWR9, _ARCH_PWR10
+                         Predefined when compiling for (at least) the corresponding POWER
+                         processor.
+
+  __riscv                Predefined when compiling for a RISC-V CPU.  "__riscv_xlen" holds the
+                         width of its integer registers (32 or 64).
+
+  __SSE2__, __SSE3__,    Predefined when the corresponding SIMD instruction set extension has
+  __SSSE3__, __SSE4_1__, been enabled.  "-mavx2" (for example) also enables every extension
+  __SSE4_2__, __AVX__,   that AVX2 builds upon, so the corresponding macros are predefined
+  __AVX2__, __FMA__,     too.
+  __AVX512F__,
+  __AVX512BW__
+
+  __ARM_NEON             Predefined when NEON (Advanced SIMD) instructions are available.
+                         Older versions of GCC predefine `__ARM_NEON__' instead.
+
+  __ARM_FEATURE_SVE      Predefined when SVE instructions are available.
+                         "__ARM_FEATURE_SVE_BITS" holds the vector length if it was fixed with
+                         "-msve-vector-bits=..." (0 if it wasn't).
+
+  __mips__               Predefined when compiling for a MIPS CPU.
+
+  __alpha__              Predefined when compiling for a DEC Alpha CPU.
+
+  __APPLE__, __MACH__    Predefined when compiling for Mac OS X (which doesn't predefine
+                         `__unix__').
+
+  _WIN32                 Predefined by the MinGW and Cygwin ports when compiling for Win32.
+
+  __clang__              Predefined by Clang, which also predefines `__GNUC__' (as 4) and
+                         `__GNUC_MINOR__' (as 2) for compatibility.
+
+  __BYTE_ORDER__         Predefined (as `__ORDER_LITTLE_ENDIAN__' or `__ORDER_BIG_ENDIAN__')
+                         by GCC 4.6 or later and by Clang.
+
+  __ARMEB__, __ARMEL__,  Predefined by older versions when compiling for a big- or little-
+  __AARCH64EB__,         endian ARM or MIPS CPU (both families can run either way).
+  __AARCH64EL__,
+  __MIPSEB__, __MIPSEL__
+
+  _REENTRANT             Predefined when "-pthread" (or "-fopenmp", which implies it) is
+                         specified.
+
+  _OPENMP                Predefined (as the date of the OpenMP specification supported) when
+                         "-fopenmp" is specified.
+
+  __STDCPP_THREADS__     Predefined (as 1) by C++11 and later when the program can have more
+                         than one thread.
+
+  _MT                    Predefined by MinGW when "-mthreads" is specified.
+
 */
 
 #ifndef COMPILER_GNU_H
 
   #define PF_COMPILER     PF_GNU
-  #define PF_COMPILER_VER __GNUC__##.##__GNUC_MINOR__
+  #define PF_COMPILER_VER ((__GNUC__ * 100) + __GNUC_MINOR__)
 
   #if defined(__unix__)
     #define PF_OS PF_UNIX
+  #elif defined(__APPLE__) && defined(__MACH__)
+    #define PF_OS PF_MACOS
+  #elif defined(_WIN32)
+    #define PF_OS PF_WIN32
   #elif defined(__vax__)
     #define PF_OS PF_VMS
   #else
     #define PF_OS PF_UNKNOWN_OS
   #endif
 
-  #if defined(_AM29K) || defined(_AM29000)
+  #if defined(__x86_64__)
+    #define PF_CPU PF_AMD_X86_64
+  #elif defined(__i386__)
+    #define PF_CPU PF_INTEL_X86
+  #elif defined(__aarch64__)
+    #define PF_CPU PF_ARM_AARCH64
+  #elif defined(__arm__)
+    #define PF_CPU PF_ARM_AARCH32
+  #elif defined(__powerpc64__)
+    #define PF_CPU PF_IBM_POWERPC64
+  #elif defined(__powerpc__)
+    #define PF_CPU PF_IBM_POWERPC
+  #elif defined(__riscv)
+    #define PF_CPU PF_RISC_V
+  #elif defined(__mips__)
+    #define PF_CPU PF_MIPS
+  #elif defined(__alpha__)
+    #define PF_CPU PF_DEC_ALPHA
+  #elif defined(_AM29K) || defined(_AM29000)
     #define PF_CPU PF_AMD_29000
   #elif defined(__mc68000__) || defined(__m68k__) || defined(__M68020__)
     #define PF_CPU PF_MOTOROLA_68X00
   #elif defined(__ns32000__)
     #define PF_CPU PF_NS_32000
   #elif defined(__vax__)
-    #define PF_CPU PF_VAX
+    #define PF_CPU PF_DEC_VAX
   #else
     #define PF_CPU PF_UNKNOWN_CPU
   #endif
 
+  #if defined(__x86_64__) && defined(__AVX512F__) && defined(__AVX512BW__) &&                 \
+      defined(__AVX512CD__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+    #define PF_X86_LEVEL 4
+  #elif defined(__x86_64__) && defined(__AVX2__) && defined(__BMI2__) && defined(__FMA__)
+    #define PF_X86_LEVEL 3
+  #elif defined(__x86_64__) && defined(__SSE4_2__) && defined(__POPCNT__)
+    #define PF_X86_LEVEL 2
+  #elif defined(__x86_64__)
+    #define PF_X86_LEVEL 1
+  #endif
+
+  #if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    #define PF_ENDIAN PF_ENDIAN_LITTLE
+  #elif defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    #define PF_ENDIAN PF_ENDIAN_BIG
+  #elif defined(__ARMEL__) || defined(__AARCH64EL__) || defined(__MIPSEL__)
+    #define PF_ENDIAN PF_ENDIAN_LITTLE
+  #elif defined(__ARMEB__) || defined(__AARCH64EB__) || defined(__MIPSEB__)
+    #define PF_ENDIAN PF_ENDIAN_BIG
+  #endif
+
+  #if defined(__ARM_ARCH)
+    #define PF_ARM_LEVEL __ARM_ARCH
+  #endif
+
+  #if defined(_ARCH_PWR10)
+    #define PF_POWER_LEVEL 10
+  #elif defined(_ARCH_PWR9)
+    #define PF_POWER_LEVEL 9
+  #elif defined(_ARCH_PWR8)
+    #define PF_POWER_LEVEL 8
+  #elif defined(_ARCH_PWR7)
+    #define PF_POWER_LEVEL 7
+  #endif
+
+  #ifdef __SSE2__
+    #define PF_SIMD_SSE2 1
+  #endif
+  #ifdef __SSE3__
+    #define PF_SIMD_SSE3 1
+  #endif
+  #ifdef __SSSE3__
+    #define PF_SIMD_SSSE3 1
+  #endif
+  #ifdef __SSE4_1__
+    #define PF_SIMD_SSE4_1 1
+  #endif
+  #ifdef __SSE4_2__
+    #define PF_SIMD_SSE4_2 1
+  #endif
+  #ifdef __AVX__
+    #define PF_SIMD_AVX 1
+  #endif
+  #ifdef __AVX2__
+    #define PF_SIMD_AVX2 1
+  #endif
+  #ifdef __FMA__
+    #define PF_SIMD_FMA 1
+  #endif
+  #ifdef __AVX512F__
+    #define PF_SIMD_AVX512F 1
+  #endif
+  #ifdef __AVX512BW__
+    #define PF_SIMD_AVX512BW 1
+  #endif
+  #if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define PF_SIMD_NEON 1
+  #endif
+  #ifdef __ARM_FEATURE_SVE
+    #define PF_SIMD_SVE 1
+    #if defined(__ARM_FEATURE_SVE_BITS) && (__ARM_FEATURE_SVE_BITS > 0)
+      #define PF_SIMD_WIDTH_BYTES (__ARM_FEATURE_SVE_BITS / 8)
+    #endif
+  #endif
+
   #define PF_STD_LIB_CALL
-  #define PF_MULTI_THREADED 0
+
+  // None of the thread macros is predefined when a program that uses threads is compiled
+  // without "-pthread" (which glibc 2.34 and later no longer require), so such a program is
+  // taken to be single-threaded; "PF_MULTITHREADED" can be defined (as 0 or 1) before
+  // <platform.h> is included to say which it is.
+
+  #ifndef PF_MULTITHREADED
+    #if defined(_REENTRANT) || defined(_OPENMP) || defined(__STDCPP_THREADS__) || defined(_MT)
+      #define PF_MULTITHREADED 1
+    #else
+      #define PF_MULTITHREADED 0
+    #endif
+  #endif
+
   #define PF_DLL_IMPORT
   #define PF_DLL_EXPORT
   #define PF_DLL_CALL
 
 #endif
 
+// ============================================================================================
+// PRAGMA DIRECTIVE MACROS
+// ============================================================================================
+
+/*
+GCC and Clang perform macro replacement in only a few pragma directives, so "#pragma PF_..."
+doesn't work with them.  Both support C99's "_Pragma()" operator (in every language mode,
+including C++98), which turns a string into a pragma directive wherever it appears --
+including in the expansion of another macro -- so "PF_PRAGMA(directive)" is defined with it
+instead.  Macros in "directive" are replaced before it's turned into a string, so the
+structure packing macros below are defined for the sake of their "PF_PRAGMA_PACKING_..."
+counterparts (see <platform.h>).
+
+The following was summarized from the GCC and Clang online manuals:
+
+  GCC ivdep               The next loop has no loop-carried dependencies that would prevent
+                          its iterations from being run simultaneously (vectorized), so the
+                          compiler needn't check for them (GCC 4.9 or later).
+
+  GCC unroll n            Unrolls the next loop "n" times (GCC 8 or later).
+
+  clang loop vectorize    "enable" or "disable" vectorizes or doesn't vectorize the next loop,
+  (option)                whatever the compiler's cost model says; "assume_safety" is the
+                          same as "GCC ivdep".
+
+  clang loop              Unrolls the next loop "n" times.
+  unroll_count(n)
+
+  GCC push_options        Saves the current optimization options on a stack.
+
+  GCC optimize            Changes the optimization options (as though they were given on the
+  ("options")             command line, "O3" or "Os" for example) for the functions defined
+                          after it (GCC 4.4 or later).
+
+  GCC pop_options         Restores the optimization options from the stack.
+
+  pack (n)                Aligns the members of structures defined after it on "n"-byte
+                          boundaries at most; "pack ()" restores the command-line setting.
+
+  pack (push)             Saves the current packing on a stack.
+
+  pack (pop)              Restores the packing from the stack.
+
+Clang doesn't accept "GCC ivdep" and GCC has no pragma that enables or disables vectorization
+for a single loop, so the "PF_LOOP_..." macros use whichever the compiler understands and are
+left undefined otherwise.  Each one must appear immediately before a "for", "while" or "do"
+statement.  Clang ignores "GCC optimize" (it can only turn optimization off for a region, which
+isn't what "PF_OPTIMIZE_FOR_..._BEGIN" asks for), so those macros are only defined for GCC.
+*/
+
+#ifndef COMPILER_GNU_H
+
+  #define PF_STRINGIZE_PRAGMA(directive) _Pragma(#directive)
+  #define PF_PRAGMA(directive)           PF_STRINGIZE_PRAGMA(directive)
+
+  // Structure packing control
+
+  #define PF_PACKING_RESET         pack()
+  #define PF_PACKING_SET(numBytes) pack(numBytes)
+  #define PF_PACKING_PUSH          pack(push)
+  #define PF_PACKING_POP           pack(pop)
+
+  // Loop optimization control
+
+  #if defined(__clang__)
+    #define PF_LOOP_VECTORIZE     PF_PRAGMA(clang loop vectorize(enable))
+    #define PF_LOOP_NO_VECTORIZE  PF_PRAGMA(clang loop vectorize(disable))
+    #define PF_LOOP_IVDEP         PF_PRAGMA(clang loop vectorize(assume_safety))
+    #define PF_LOOP_UNROLL(count) PF_PRAGMA(clang loop unroll_count(count))
+  #else
+    #if (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))
+      #define PF_LOOP_IVDEP PF_PRAGMA(GCC ivdep)
+    #endif
+
+    #if (__GNUC__ >= 8)
+      #define PF_LOOP_UNROLL(count) PF_PRAGMA(GCC unroll count)
+    #endif
+  #endif
+
+  // Optimization control
+
+  #if !defined(__clang__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 4)))
+    #define PF_OPTIMIZE_FOR_SPEED_BEGIN                                                       \
+      PF_PRAGMA(GCC push_options) PF_PRAGMA(GCC optimize("O3"))
+    #define PF_OPTIMIZE_FOR_SIZE_BEGIN                                                        \
+      PF_PRAGMA(GCC push_options) PF_PRAGMA(GCC optimize("Os"))
+    #define PF_OPTIMIZE_END PF_PRAGMA(GCC pop_options)
+  #endif
+
+#endif
+
+// ============================================================================================
+// FUNCTION ATTRIBUTE MACROS
+// ============================================================================================
+
+/*
+The following was summarized from the GCC online manual:
+
+  target ("string")       On the x86, enables instruction set extensions (for example,
+                          "avx2") for a single function, whatever the command-line options
+                          were.  Intrinsics for those extensions may be used in the function
+                          (GCC 4.9 or later).  The function must only be called on a CPU that
+                          supports them.
+
+  target_clones           Compiles the function once for each target in the comma-separated
+  ("options")             list (which must include "default") and selects the best clone for
+                          the CPU when the program is loaded (GCC 6 or later).
+
+  ifunc ("resolver")      Declares the function to be an indirect function.  The dynamic
+                          loader calls "resolver" once, when the program or library is loaded,
+                          and binds every call to the function to the routine it returns.
+                          Only available for ELF targets whose C library supports the
+                          STT_GNU_IFUNC symbol type (GNU/Linux with glibc 2.11 or later --
+                          notably not musl).
+
+  hot                     The function is a hot spot:  it's optimized more aggressively and
+                          placed with other hot functions in a subsection of the text section
+                          (GCC 4.3 or later).
+
+  cold                    The function is unlikely to be executed:  it's optimized for size,
+                          placed in a subsection of the text section away from the rest of the
+                          code, and branches that lead to calls to it are predicted not to be
+                          taken (GCC 4.3 or later).
+
+  noinline                Prevents the function from being inlined.
+
+  always_inline           Inlines the function even when optimization is off and whatever the
+                          compiler's heuristics say (it must also be declared "inline").
+
+  optimize ("options")    Compiles the function with different optimization options from the
+                          command line's ("O3" or "Os", for example) -- the attribute form of
+                          "#pragma GCC optimize" (GCC 4.4 or later).  Clang ignores it.
+
+  pure                    The function has no effects except its return value, which depends
+                          only on its parameters and on global memory (including memory that
+                          its pointer parameters point to).  Calls to it can be merged or
+                          moved out of loops as long as the memory isn't changed in between.
+
+  const                   Like "pure", but the return value depends only on the parameters --
+                          the function doesn't read memory at all (not even through pointer
+                          parameters).
+
+Clang also accepts all of these attributes.
+
+"PF_TARGET_..." macros are only defined when the corresponding instruction set extensions can
+be enabled for a single function, so that "#ifdef" can be used to decide whether or not to
+compile a variant of a routine for them.
+*/
+
+#ifndef COMPILER_GNU_H
+
+  // Instruction set targeting
+
+  #if (defined(__i386__) || defined(__x86_64__)) &&                                          \
+      (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+    #define PF_TARGET_SSE4_2 __attribute__((target("sse4.2,popcnt")))
+    #define PF_TARGET_AVX2   __attribute__((target("avx2,fma,bmi,bmi2")))
+    #define PF_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512cd,"            \
+                                                   "avx512bw,avx512vl")))
+  #endif
+
+  #if defined(__aarch64__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define PF_TARGET_NEON
+  #endif
+
+  #if (defined(__clang__) && (__clang_major__ >= 14)) ||                                      \
+      (!defined(__clang__) && (__GNUC__ >= 6))
+    #define PF_TARGET_CLONES(targets) __attribute__((target_clones(targets)))
+  #endif
+
+  // Load-time binding
+
+  #if defined(__ELF__) && defined(__linux__) && !defined(__ANDROID__) &&                     \
+      (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 6)))
+    #define PF_IFUNC(resolver) __attribute__((ifunc(resolver)))
+  #endif
+
+  // Code placement and inlining
+
+  #if defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 3))
+    #define PF_HOT  __attribute__((hot))
+    #define PF_COLD __attribute__((cold))
+  #endif
+
+  #define PF_NOINLINE __attribute__((noinline))
+
+  #ifdef __cplusplus
+    #define PF_FORCE_INLINE __inline__ __attribute__((always_inline))
+  #else
+    #define PF_FORCE_INLINE static __inline__ __attribute__((always_inline))
+  #endif
+
+  #if !defined(__clang__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 4)))
+    #define PF_OPTIMIZE_FN(level) __attribute__((optimize(level)))
+  #endif
+
+  // Purity
+
+  #define PF_PURE     __attribute__((pure))
+  #define PF_CONST_FN __attribute__((const))
+
+#endif
+
+// ============================================================================================
+// DATA ATTRIBUTE MACROS
+// ============================================================================================
+
+/*
+The following was summarized from the GCC online manual:
+
+  aligned (alignment)     Aligns a type, variable or structure member to at least "alignment"
+                          bytes (a power of 2).  Applied to a type, the type's size is also
+                          rounded up to a multiple of "alignment", so every element of an array
+                          of that type is aligned too.
+
+  tls_model ("model")     Sets the thread-local storage model of a "__thread" variable to
+                          "global-dynamic", "local-dynamic", "initial-exec" or "local-exec".
+                          "initial-exec" variables are found at a fixed offset from the thread
+                          pointer instead of through a call to "__tls_get_addr()", even in
+                          shared libraries, but a library that uses it may fail to load with
+                          "dlopen()" if the static TLS block has no room left.
+
+Clang also accepts these attributes.  The "__thread" storage class (GCC 3.3 or later) declares
+a thread-local variable; it's emulated where the object file format has no native support.
+"tls_model" only applies to ELF.
+
+The "__restrict__" type qualifier is C99's "restrict" in every language mode (including C++):
+a pointer qualified with it is the only way that the object it points to is accessed while the
+pointer is in scope, so the compiler needn't check whether stores through other pointers
+change it.
+*/
+
+#ifndef COMPILER_GNU_H
+
+  #define PF_ALIGNAS(numBytes) __attribute__((aligned(numBytes)))
+  #define PF_THREAD_LOCAL      __thread
+  #define PF_RESTRICT          __restrict__
+
+  #if defined(__ELF__)
+    #define PF_TLS_INITIAL_EXEC __attribute__((tls_model("initial-exec")))
+  #endif
+
+#endif
+
+// ============================================================================================
+// BUILT-IN FUNCTION MACROS
+// ============================================================================================
+
+/*
+GCC 4.3 introduced "__builtin_bswap32()" and "__builtin_bswap64()", and GCC 4.8 introduced
+"__builtin_bswap16()".  Each reverses the order of an integer's bytes and compiles to a single
+instruction where the CPU has one ("bswap", "movbe" or "rol" on the x86, "rev" or "rev16" on
+ARM, "lwbrx" on the PowerPC, etc.).  Clang supports all three.
+
+"__builtin_ia32_pause()" (GCC 4.7 or later, and Clang) compiles to the x86's "pause"
+instruction, which tells the CPU that it's in a spin-wait loop:  it stops speculating past the
+loop (which makes leaving it faster) and gives the core's resources to its hyperthread sibling
+for a while.  Other CPUs need inline assembly.  On AArch64, "yield" does nothing on most cores
+so "isb" (which stalls until the pipeline drains) is used instead; the PowerPC's equivalent is
+"or 27,27,27", which lowers the hardware thread's priority.
+
+"__builtin_expect(expression, value)" returns "expression" and tells the compiler that it's
+probably equal to "value", so the expected path is laid out as the straight-line one and the
+other is moved out of the way (with "-freorder-blocks", which "-O2" enables).
+
+"__builtin_unreachable()" (GCC 4.5 or later) tells the compiler that a point in the program is
+never reached, so a condition that would lead there can be assumed to be false; Clang's
+"__builtin_assume(condition)" does the same thing directly.  "__builtin_assume_aligned(pointer,
+alignment)" (GCC 4.7 or later, and Clang) returns "pointer" (as a "void*") and tells the
+compiler that it's aligned to "alignment" bytes, so loads and stores through it can use
+aligned vector instructions without a run-time check.
+*/
+
+#ifndef COMPILER_GNU_H
+
+  // Byte order reversal
+
+  #if defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 8))
+    #define PF_BSWAP16(value) __builtin_bswap16(value)
+  #endif
+
+  #if defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 3))
+    #define PF_BSWAP32(value) __builtin_bswap32(value)
+    #define PF_BSWAP64(value) __builtin_bswap64(value)
+  #endif
+
+  // Spin-wait hints
+
+  #if (defined(__i386__) || defined(__x86_64__)) &&                                          \
+      (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 7)))
+    #define PF_CPU_RELAX() __builtin_ia32_pause()
+  #elif defined(__i386__) || defined(__x86_64__)
+    #define PF_CPU_RELAX() __asm__ __volatile__("rep; nop" ::: "memory")
+  #elif defined(__aarch64__)
+    #define PF_CPU_RELAX() __asm__ __volatile__("isb" ::: "memory")
+  #elif defined(__arm__) && defined(__ARM_ARCH) && (__ARM_ARCH >= 7)
+    #define PF_CPU_RELAX() __asm__ __volatile__("yield" ::: "memory")
+  #elif defined(__powerpc__)
+    #define PF_CPU_RELAX() __asm__ __volatile__("or 27,27,27" ::: "memory")
+  #endif
+
+  // Branch prediction hints
+
+  #define PF_LIKELY(condition)   __builtin_expect(!!(condition), 1)
+  #define PF_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+
+  // Optimizer assumptions
+
+  #if defined(__clang__)
+    #define PF_ASSUME(condition) __builtin_assume(condition)
+  #elif (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 5))
+    #define PF_ASSUME(condition) ((condition) ? (void)0 : __builtin_unreachable())
+  #endif
+
+  #if defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 7))
+    #define PF_ASSUME_ALIGNED(pointer, alignment) __builtin_assume_aligned(pointer, alignment)
+  #endif
+
+#endif
+
 // ============================================================================================
 // GUARD MACRO DEFINITION
 // ============================================================================================
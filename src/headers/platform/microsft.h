@@ -4,7 +4,7 @@
 //
 // ============================================================================================
 
-#ifndef PLATFORM_H
+#ifndef PF_MICROSOFT
   #error platform.h has not been included yet.
 #endif
 
@@ -77,6 +77,24 @@ The following was taken from the help files of Microsoft Visual C++ 6.0:
   PowerPC 604            /QP604        _M_MPPC = 604
   PowerPC 620            /QP620        _M_MPPC = 620
 
+The following was summarized from the online documentation for more recent versions of
+Microsoft Visual C++:
+
+  _M_X64, _M_AMD64 Defined as 100 when compiling for x64 processors.
+
+  _M_ARM           Defined as 7 when compiling for ARM processors.
+
+  _M_ARM64         Defined as 1 when compiling for ARM64 processors.
+
+  _M_IX86_FP       Defined as 1 if /arch:SSE is specified, 2 if /arch:SSE2 (the default as of
+                   Visual C++ 2012) or higher is specified and 0 otherwise.  Only defined for
+                   x86 processors -- SSE2 is always available on x64 processors.
+
+  __AVX__,         Defined when /arch:AVX, /arch:AVX2 or /arch:AVX512 (respectively, and
+  __AVX2__,        cumulatively) is specified.  There's no option between the x64 baseline and
+  __AVX512F__,     AVX, so x86-64-v2 can't be detected (but every AVX processor supports SSE3
+  __AVX512BW__     through SSE4.2 as well).  /arch:AVX2 also allows FMA instructions.
+
 */
 
 #ifndef COMPILER_MICRSOFT_H
@@ -96,16 +114,75 @@ The following was taken from the help files of Microsoft Visual C++ 6.0:
     #define PF_CPU PF_DEC_ALPHA
   #elif defined(_M_MPPC) || defined(_M_PPC)
     #define PF_CPU PF_IBM_POWERPC
+  #elif defined(_M_X64) || defined(_M_AMD64)
+    #define PF_CPU PF_AMD_X86_64
   #elif defined(_M_IX86)
-    #define PF_CPU PF_INTEL_80X86
+    #define PF_CPU PF_INTEL_X86
+  #elif defined(_M_ARM64)
+    #define PF_CPU PF_ARM_AARCH64
+  #elif defined(_M_ARM)
+    #define PF_CPU PF_ARM_AARCH32
   #elif defined(_M_MRX000)
     #define PF_CPU PF_MIPS
   #else
     #define PF_CPU PF_UNKNOWN_CPU
   #endif
 
+  // Windows runs every CPU in little-endian mode (even the PowerPC, MIPS and ARM, which can
+  // run either way), but the Macintosh runs the PowerPC in big-endian mode.
+
+  #if defined(_M_MPPC)
+    #define PF_ENDIAN PF_ENDIAN_BIG
+  #else
+    #define PF_ENDIAN PF_ENDIAN_LITTLE
+  #endif
+
+  #if (defined(_M_X64) || defined(_M_AMD64)) && defined(__AVX512F__)
+    #define PF_X86_LEVEL 4
+  #elif (defined(_M_X64) || defined(_M_AMD64)) && defined(__AVX2__)
+    #define PF_X86_LEVEL 3
+  #elif defined(_M_X64) || defined(_M_AMD64)
+    #define PF_X86_LEVEL 1
+  #endif
+
+  #if defined(_M_ARM64)
+    #define PF_ARM_LEVEL 8
+  #elif defined(_M_ARM)
+    #define PF_ARM_LEVEL _M_ARM
+  #endif
+
+  #if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define PF_SIMD_SSE2 1
+  #endif
+  #ifdef __AVX__
+    #define PF_SIMD_SSE3   1
+    #define PF_SIMD_SSSE3  1
+    #define PF_SIMD_SSE4_1 1
+    #define PF_SIMD_SSE4_2 1
+    #define PF_SIMD_AVX    1
+  #endif
+  #ifdef __AVX2__
+    #define PF_SIMD_AVX2 1
+    #define PF_SIMD_FMA  1
+  #endif
+  #ifdef __AVX512F__
+    #define PF_SIMD_AVX512F 1
+  #endif
+  #ifdef __AVX512BW__
+    #define PF_SIMD_AVX512BW 1
+  #endif
+  #if defined(_M_ARM) || defined(_M_ARM64)
+    #define PF_SIMD_NEON 1
+  #endif
+
   #define PF_STD_LIB_CALL   _cdecl
-  #define PF_MULTI_THREADED defined(_MT)
+
+  #ifdef _MT
+    #define PF_MULTITHREADED 1
+  #else
+    #define PF_MULTITHREADED 0
+  #endif
+
   #define PF_DLL_IMPORT     _import
   #define PF_DLL_EXPORT     _export
 
@@ -1036,11 +1113,182 @@ The following was taken from the help files of Microsoft Visual C++ 6.0:
 #define PF_INCLUDE_ONCE_ONLY                       once
 #define PF_SETLOCALE(locale)                       setlocale(locale)
 
+// Pragma directives in macros
+//
+// Visual C++ 2008 and later accept "__pragma(directive)", which works like C99's "_Pragma()"
+// operator but takes the directive itself rather than a string.  Visual C++ 2012 introduced
+// "loop(ivdep)" and "loop(no_vector)", which apply to the loop that follows them; there's no
+// pragma to force vectorization or unrolling, so "PF_LOOP_VECTORIZE" and "PF_LOOP_UNROLL()"
+// aren't defined.
+
+#if (_MSC_VER >= 1500)
+  #define PF_PRAGMA(directive)                     __pragma(directive)
+#endif
+
+#if (_MSC_VER >= 1700)
+  #define PF_LOOP_IVDEP                            __pragma(loop(ivdep))
+  #define PF_LOOP_NO_VECTORIZE                     __pragma(loop(no_vector))
+#endif
+
+// Optimization control
+//
+// "optimize" changes the optimizations used for the functions defined after it:  "g" enables
+// global optimizations, "s" favours small code and "t" fast code, and an empty list with "on"
+// restores the optimizations given on the command line.  It can't be nested, so
+// "PF_OPTIMIZE_END" always goes back to the command line's settings.  There's no way to
+// change the optimizations for a single function, so "PF_OPTIMIZE_FN()" isn't defined.
+
+#if (_MSC_VER >= 1500)
+  #define PF_OPTIMIZE_FOR_SPEED_BEGIN              __pragma(optimize("gt", on))
+  #define PF_OPTIMIZE_FOR_SIZE_BEGIN               __pragma(optimize("gs", on))
+  #define PF_OPTIMIZE_END                          __pragma(optimize("", on))
+#endif
+
 // init_seg?
 // pointers_to_members?
-// optimize?
 // warning?
 
+// ============================================================================================
+// FUNCTION ATTRIBUTE MACROS
+// ============================================================================================
+
+/*
+Microsoft compilers don't need a function to be marked before it can use an instruction set
+extension's intrinsics -- the intrinsics for every extension that the compiler knows about may
+be used anywhere (SSE4.2 as of Visual C++ 2008, AVX2 as of Visual C++ 2012 and AVX-512 as of
+Visual C++ 2017).  The "PF_TARGET_..." macros are therefore defined as nothing, but only for
+the extensions that the compiler can generate code for.
+
+Microsoft compilers can't compile a function several times for different targets, nor can they
+bind a function at load time, so "PF_TARGET_CLONES" and "PF_IFUNC" aren't defined.
+
+Visual C++ 6.0 introduced "__forceinline", which inlines a function unless it's impossible
+(a recursive or virtual call, for example), and Visual C++ .NET 2002 introduced
+"__declspec(noinline)", which prevents a function from being inlined.  There's no way to mark
+a function as hot or cold, nor a built-in function for predicting a branch ("[[likely]]" and
+"[[unlikely]]" in C++20 are attached to statements, not expressions, so they can't be used by
+"PF_LIKELY()"), so "PF_HOT", "PF_COLD", "PF_LIKELY()" and "PF_UNLIKELY()" aren't defined.
+Profile-guided optimization does the same job.
+
+Visual C++ 2005 introduced "__declspec(noalias)", which means that a function reads and writes
+no memory except through its pointer parameters (and then only the objects that they point to
+directly).  A function that's "const" in GCC's sense (see "PF_CONST_FN") satisfies that, but
+one that's only "pure" (it may read global memory) doesn't, so "PF_PURE" isn't defined.
+*/
+
+#ifndef COMPILER_MICROSFT_H
+
+  // Instruction set targeting
+
+  #if (defined(_M_IX86) || defined(_M_X64)) && (_MSC_VER >= 1500)
+    #define PF_TARGET_SSE4_2
+  #endif
+
+  #if (defined(_M_IX86) || defined(_M_X64)) && (_MSC_VER >= 1700)
+    #define PF_TARGET_AVX2
+  #endif
+
+  #if (defined(_M_IX86) || defined(_M_X64)) && (_MSC_VER >= 1910)
+    #define PF_TARGET_AVX512
+  #endif
+
+  #if defined(_M_ARM) || defined(_M_ARM64)
+    #define PF_TARGET_NEON
+  #endif
+
+  // Inlining
+
+  #if (_MSC_VER >= 1200)
+    #define PF_FORCE_INLINE __forceinline
+  #endif
+
+  #if (_MSC_VER >= 1300)
+    #define PF_NOINLINE __declspec(noinline)
+  #endif
+
+  // Purity
+
+  #if (_MSC_VER >= 1400)
+    #define PF_CONST_FN __declspec(noalias)
+  #endif
+
+#endif
+
+// ============================================================================================
+// DATA ATTRIBUTE MACROS
+// ============================================================================================
+
+/*
+Visual C++ .NET 2002 introduced "__declspec(align(n))", which aligns a type or variable to at
+least "n" bytes (a power of 2 no greater than 8192, given as a literal number).  Applied to a
+type, the type's size is also rounded up to a multiple of "n".
+
+"__declspec(thread)" declares a thread-local variable.  Before Windows Vista it doesn't work in
+a DLL that's loaded with "LoadLibrary()".  Windows's thread-local variables are always at a
+fixed offset from the TEB (the equivalent of "initial-exec"), so there's no model to choose.
+
+Visual C++ 2005 introduced the "__restrict" type qualifier, which is C99's "restrict" in C and
+C++ alike.
+*/
+
+#ifndef COMPILER_MICROSFT_H
+
+  #if (_MSC_VER >= 1300)
+    #define PF_ALIGNAS(numBytes) __declspec(align(numBytes))
+  #endif
+
+  #if (_MSC_VER >= 1400)
+    #define PF_RESTRICT __restrict
+  #endif
+
+  #define PF_THREAD_LOCAL __declspec(thread)
+
+#endif
+
+// ============================================================================================
+// BUILT-IN FUNCTION MACROS
+// ============================================================================================
+
+/*
+Visual C++ 2005 introduced "_byteswap_ushort()", "_byteswap_ulong()" and "_byteswap_uint64()",
+which reverse the order of an integer's bytes and are compiled inline (to "bswap" on the x86
+and "rev" on ARM).  They're declared in <stdlib.h>, which must be included before they're used.
+
+"_mm_pause()" (x86 and x64), "__isb()" (ARM64) and "__yield()" (ARM) tell the CPU that it's
+in a spin-wait loop.  They're declared in <intrin.h>, which must be included before they're
+used.
+
+"__assume(condition)" tells the optimizer that "condition" is true without generating any code
+to evaluate it.  There's no built-in function that asserts a pointer's alignment, so
+"PF_ASSUME_ALIGNED()" isn't defined.
+*/
+
+#ifndef COMPILER_MICROSFT_H
+
+  // Byte order reversal
+
+  #if (_MSC_VER >= 1400)
+    #define PF_BSWAP16(value) _byteswap_ushort(value)
+    #define PF_BSWAP32(value) _byteswap_ulong(value)
+    #define PF_BSWAP64(value) _byteswap_uint64(value)
+  #endif
+
+  // Spin-wait hints
+
+  #if (_MSC_VER >= 1400) && (defined(_M_IX86) || defined(_M_X64) || defined(_M_AMD64))
+    #define PF_CPU_RELAX() _mm_pause()
+  #elif defined(_M_ARM64)
+    #define PF_CPU_RELAX() __isb(_ARM64_BARRIER_SY)
+  #elif defined(_M_ARM)
+    #define PF_CPU_RELAX() __yield()
+  #endif
+
+  // Optimizer assumptions
+
+  #define PF_ASSUME(condition) __assume(condition)
+
+#endif
+
 // ============================================================================================
 // COMPILER DEFICIENCY CORRECTIONS
 // ============================================================================================
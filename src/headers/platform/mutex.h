@@ -0,0 +1,157 @@
+#ifndef PLATFORM_MUTEX_H
+#define PLATFORM_MUTEX_H
+
+// ============================================================================================
+//
+// mutex.h -- Adaptive Mutexes and Waiting on Addresses
+//
+// ============================================================================================
+
+/*
+A thread that finds a mutex locked usually has two choices:  spin until it's unlocked, which
+wastes the CPU (and slows down the hyperthread beside it) if the holder takes long, or ask the
+operating system to put it to sleep, which costs a system call and a context switch even if
+the holder was about to unlock it.  A "pf::adaptive_mutex" does both -- it spins for a while,
+with "PF_CPU_RELAX()" and an exponentially growing back-off, and only sleeps if the mutex is
+still locked after that:
+
+  #include <platform/mutex.h>
+
+  pf::adaptive_mutex bookLock;
+
+  bookLock.lock();
+  ...                                                           // a short critical section
+  bookLock.unlock();
+
+"try_lock()" locks the mutex if it isn't locked and returns whether it did.  Locking and
+unlocking an uncontended mutex is a single atomic operation each, and unlocking never makes a
+system call unless another thread is asleep waiting for the mutex.  The number of rounds of
+spinning can be changed by defining "PF_MUTEX_SPIN_ROUNDS" (the n'th round spins 2^n times)
+when "src/code/mutex.cpp" is compiled.  A "pf::adaptive_mutex" isn't recursive and isn't fair.
+
+The sleeping is done by the following routines, which can also be used directly to wait for
+any 32-bit atomic integer (see <platform/atomic.h>) to change:
+
+  void pf_wait_on_address(pf_atomic32_t* address, int32_t expected)
+  void pf_wake_by_address_single(pf_atomic32_t* address)
+  void pf_wake_by_address_all(pf_atomic32_t* address)
+
+"pf_wait_on_address()" returns at once if "*address" isn't "expected"; otherwise it sleeps
+until another thread calls one of the "pf_wake_by_address_...()" routines for "address".  It
+can also return spuriously, so it should be called in a loop that checks for the awaited
+change.  They're built on Linux's "futex()" system call and on Windows 8's "WaitOnAddress()"
+(in Synchronization.lib).  Everywhere else, waiting yields the CPU instead of sleeping and
+waking does nothing, which works but is only suitable for short waits.
+
+"src/code/mutex.cpp" must be compiled into the program.
+
+NOTE:  This header file requires a C++ compiler that supports namespaces.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <platform.h>
+#include <platform/atomic.h>
+
+// ============================================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================================
+
+void pf_wait_on_address(pf_atomic32_t*, const int32_t);
+void pf_wake_by_address_single(pf_atomic32_t*);
+void pf_wake_by_address_all(pf_atomic32_t*);
+
+namespace pf
+{
+
+// ============================================================================================
+// CLASS DEFINITIONS
+// ============================================================================================
+
+class adaptive_mutex
+{
+  public:
+    adaptive_mutex() {pf_atomic_store32(&_state, 0, PF_MEMORY_ORDER_RELAXED);}
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+  private:
+    pf_atomic32_t _state;                  // 0 = unlocked, 1 = locked, 2 = locked with waiters
+
+    void lockContended();
+
+    adaptive_mutex(const adaptive_mutex&);                                      // not copyable
+    adaptive_mutex& operator=(const adaptive_mutex&);
+};
+
+// ============================================================================================
+// INLINE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+inline void adaptive_mutex::lock()
+
+/*
+This function locks the mutex, waiting for it to be unlocked if necessary.
+
+PRECONDITIONS:
+The calling thread mustn't have locked the mutex already.
+
+POSTCONDITIONS:
+The mutex is locked by the calling thread.
+*/
+
+{
+  int32_t unlocked = 0;
+
+  if (PF_UNLIKELY(!pf_atomic_cas32(&_state, &unlocked, 1, PF_MEMORY_ORDER_ACQUIRE)))
+    lockContended();
+}
+
+/*********************************************************************************************/
+
+inline bool adaptive_mutex::try_lock()
+
+/*
+This function locks the mutex if it isn't locked.
+
+PRECONDITIONS:
+The calling thread mustn't have locked the mutex already.
+
+POSTCONDITIONS:
+true is returned if the mutex is now locked by the calling thread, false otherwise.
+*/
+
+{
+  int32_t unlocked = 0;
+
+  return pf_atomic_cas32(&_state, &unlocked, 1, PF_MEMORY_ORDER_ACQUIRE) != 0;
+}
+
+/*********************************************************************************************/
+
+inline void adaptive_mutex::unlock()
+
+/*
+This function unlocks the mutex and wakes a thread that's asleep waiting for it (if any).
+
+PRECONDITIONS:
+The mutex must be locked by the calling thread.
+
+POSTCONDITIONS:
+The mutex is unlocked.
+*/
+
+{
+  if (pf_atomic_exchange32(&_state, 0, PF_MEMORY_ORDER_RELEASE) == 2)
+    pf_wake_by_address_single(&_state);
+}
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef PLATFORM_NUMA_H
+#define PLATFORM_NUMA_H
+
+// ============================================================================================
+//
+// numa.h -- NUMA Topology and Node-Local Allocation
+//
+// ============================================================================================
+
+/*
+On a computer with more than one CPU socket, each socket has memory of its own (a NUMA "node")
+and reading another socket's memory is much slower than reading its own.  By default, a page
+is placed on the node of the thread that first writes to it, which is usually right for memory
+that one thread uses but wrong for memory that's shared.  The routines declared here let a
+program find out how many nodes there are and which one a thread is running on, and allocate
+memory on a particular node or spread evenly across all of them:
+
+  #include <platform/numa.h>
+
+  int   tier;
+  char* table  = (char*)pf_numa_alloc_interleaved(tableSize, &tier);         // shared by all
+  char* buffer = (char*)pf_numa_alloc_on_node(bufferSize, pf_numa_current_node(), &tier);
+  ...
+  pf_large_free(buffer, bufferSize);
+  pf_large_free(table, tableSize);
+
+Both allocation routines are variants of "pf_large_alloc()" (see <platform/alloc.h>):  blocks
+are allocated, reported and freed the same way.  Placement is a request, not a guarantee:  if
+a node runs out of memory then the operating system uses another one, and where NUMA isn't
+supported (or the computer only has one node) the memory is simply allocated.
+
+Nodes are numbered from 0 to "pf_numa_node_count()" - 1.  The topology is read once (either
+during static initialization or on the first call, whichever comes first) and the result is
+cached.  On Linux it's read from "/sys/devices/system/node" and memory is placed with the
+"mbind()" system call, so the libnuma library isn't needed.
+
+"src/code/numa.cpp" and "src/code/alloc.cpp" must be compiled into the program.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stddef.h>
+
+#include <platform.h>
+#include <platform/alloc.h>
+
+// ============================================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================================
+
+int   pf_numa_node_count(void);
+int   pf_numa_current_node(void);
+void* pf_numa_alloc_on_node(const size_t, const int, int*);
+void* pf_numa_alloc_interleaved(const size_t, int*);
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef PLATFORM_POOL_H
+#define PLATFORM_POOL_H
+
+// ============================================================================================
+//
+// pool.h -- Fixed-Size Block Pools
+//
+// ============================================================================================
+
+/*
+A "pf::pool<T>" allocates and frees objects of one type much faster than "new" and "delete"
+can, and without contending for the heap's locks when several threads use it at once:
+
+  #include <platform/pool.h>
+
+  static pf::pool<Connection> connections;
+
+  Connection* connection = connections.create();
+  ...
+  connections.destroy(connection);
+
+("allocate()" and "deallocate()" do the same without calling a constructor or destructor.)
+
+Blocks are carved out of large slabs, which are never returned to the operating system (or
+heap) until the pool is destroyed.  Blocks of up to "PF_CACHE_LINE_SIZE" bytes are rounded up
+to a power of 2 so that none of them straddles two cache lines, and larger ones are rounded
+up to a whole number of cache lines.  Slabs of "PF_LARGE_PAGE_SIZE" bytes or more come from
+"pf_large_alloc()" and so are backed by huge pages where possible.
+
+A pool is thread-safe.  Freed blocks are kept in a small number of per-thread caches, each on
+a cache line of its own, so that a thread usually reuses the blocks it freed itself without
+touching memory shared with other threads; blocks move between threads through a lock-free
+list.  A thread may free a block that was allocated by another thread.  For the caches to be
+aligned, a pool should be a static variable or a member of one (before C++17, "new" doesn't
+honour the alignment).
+
+Every block must be freed before the pool is destroyed.
+
+"src/code/pool.cpp" and "src/code/alloc.cpp" must be compiled into the program.
+
+NOTE:  This header file requires a C++ compiler that supports namespaces and templates.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stddef.h>
+#include <new>
+
+#include <platform.h>
+#include <platform/align.h>
+#include <platform/alloc.h>
+#include <platform/atomic.h>
+
+// ============================================================================================
+// MACRO DEFINITIONS
+// ============================================================================================
+
+// The default size of a pool's slabs
+
+#ifndef PF_POOL_SLAB_SIZE
+  #define PF_POOL_SLAB_SIZE 0x10000UL
+#endif
+
+// The number of per-thread caches in each pool
+
+#ifndef PF_POOL_CACHES
+  #define PF_POOL_CACHES 16
+#endif
+
+namespace pf
+{
+
+// ============================================================================================
+// CLASS DEFINITIONS
+// ============================================================================================
+
+// The type-independent part of "pool<T>"
+
+class pool_base
+{
+  public:
+    pool_base(const size_t blockSize, const size_t slabSize);
+    ~pool_base();
+
+    void* allocate();
+    void  deallocate(void* block);
+
+    size_t block_size() const {return _blockSize;}
+
+  private:
+    struct block
+    {
+      block* next;                                                       // the next free block
+    };
+
+    struct cache
+    {
+      pf_atomic_ptr_t busy;                              // non-NULL while a thread is using it
+      block*          head;                                           // the first cached block
+      size_t          count;                     // the number of blocks freed since the refill
+    };
+
+    size_t          _blockSize;                                // the size of a block, in bytes
+    size_t          _slabSize;                                  // the size of a slab, in bytes
+    pf_atomic_ptr_t _free;                                  // the blocks shared by all threads
+    pf_atomic_ptr_t _slabs;                                      // every slab allocated so far
+    padded<cache>   _caches[PF_POOL_CACHES];                           // the per-thread caches
+
+    cache* lockCache();
+    block* grow(cache*);
+
+    pool_base(const pool_base&);                                                // not copyable
+    pool_base& operator=(const pool_base&);
+};
+
+// A pool of blocks for objects of type "T"
+
+template <class T> class pool: private pool_base
+{
+  public:
+    pool(const size_t slabSize = PF_POOL_SLAB_SIZE): pool_base(sizeof(T), slabSize) {}
+
+    T*   allocate()                {return (T*)pool_base::allocate();}
+    void deallocate(T* object)     {pool_base::deallocate(object);}
+
+    T*   create();
+    T*   create(const T& original);
+    void destroy(T* object);
+
+    using pool_base::block_size;
+};
+
+// ============================================================================================
+// INLINE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+template <class T> T* pool<T>::create()
+
+/*
+This function allocates a block and default-constructs a "T" in it.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+A pointer to the new object is returned, or NULL if the block couldn't be allocated.
+*/
+
+{
+  void* const memory = allocate();
+
+  return (memory != NULL) ? new (memory) T() : NULL;
+}
+
+/*********************************************************************************************/
+
+template <class T> T* pool<T>::create
+(
+  const T& original                                                       // the object to copy
+)
+
+/*
+This function allocates a block and copy-constructs a "T" in it.
+
+PRECONDITIONS:
+None.
+
+POSTCONDITIONS:
+A pointer to the new object is returned, or NULL if the block couldn't be allocated.
+*/
+
+{
+  void* const memory = allocate();
+
+  return (memory != NULL) ? new (memory) T(original) : NULL;
+}
+
+/*********************************************************************************************/
+
+template <class T> void pool<T>::destroy
+(
+  T* object                                                            // the object to destroy
+)
+
+/*
+This function destroys an object created by "create()" and frees its block.
+
+PRECONDITIONS:
+"object" must be NULL or have been returned by "create()" on this pool (and not destroyed
+since).
+
+POSTCONDITIONS:
+The object is destroyed and its block is freed.  Nothing is done if "object" is NULL.
+*/
+
+{
+  if (object != NULL)
+  {
+    object->~T();
+    deallocate(object);
+  }
+}
+
+}
+
+#endif
@@ -0,0 +1,444 @@
+#ifndef PLATFORM_RING_H
+#define PLATFORM_RING_H
+
+// ============================================================================================
+//
+// ring.h -- Lock-Free Ring Buffers
+//
+// ============================================================================================
+
+/*
+Threads that hand work to each other through a queue guarded by a mutex spend most of their
+time taking turns at the mutex.  The ring buffers defined here are bounded queues that need no
+locks at all:
+
+  pf::spsc_ring<T>   one producer thread and one consumer thread
+  pf::mpmc_ring<T>   any number of producer and consumer threads
+
+For example:
+
+  #include <platform/ring.h>
+
+  pf::spsc_ring<Message> queue(1024);
+
+  // Producer                                   // Consumer
+
+  while (!queue.try_push(message))              while (!queue.try_pop(message))
+    ;                                             ;
+
+"try_push()" returns false if the ring is full and "try_pop()" returns false if it's empty;
+neither ever waits, so it's up to the caller to decide whether to spin, yield or do something
+else.  "push_batch()" and "pop_batch()" transfer as many items from or to an array as they can
+without waiting (up to a given number) and return how many they transferred; a batch costs
+about the same as a single item, so stages that pass items along in bursts should use them.
+
+The capacity given to the constructor is rounded up to a power of 2 (at least 2).  It can be
+no greater than 0x40000000.  "T" must be default-constructible and assignable:  every slot
+holds a "T" for as long as the ring exists, and items are copied in and out by assignment.
+
+The positions that the producers and the consumers update are kept on separate cache lines, so
+that they don't slow each other down by false sharing (see <platform/align.h>).  A
+"pf::mpmc_ring" is Dmitry Vyukov's bounded queue:  each slot has a sequence number that says
+whether it's ready to be written or read in the current lap, so producers and consumers only
+contend with each other when they're working on the same slot.
+
+NOTE:  This header file requires a C++ compiler that supports namespaces and templates.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stddef.h>
+
+#include <platform.h>
+#include <platform/align.h>
+#include <platform/atomic.h>
+
+namespace pf
+{
+
+// ============================================================================================
+// CLASS DEFINITIONS
+// ============================================================================================
+
+// A ring for one producer thread and one consumer thread
+
+template <class T> class spsc_ring
+{
+  public:
+    spsc_ring(const size_t capacity);
+    ~spsc_ring() {delete[] _slots;}
+
+    bool   try_push(const T& item) {return push_batch(&item, 1) != 0;}
+    bool   try_pop(T& item)        {return pop_batch(&item, 1) != 0;}
+    size_t push_batch(const T* items, const size_t count);
+    size_t pop_batch(T* items, const size_t count);
+
+    size_t capacity() const {return (size_t)_mask + 1;}
+
+  private:
+    struct producer
+    {
+      pf_atomic32_t head;                                         // the next position to write
+      uint32_t      tail;                                // the consumer's "tail", as last read
+    };
+
+    struct consumer
+    {
+      pf_atomic32_t tail;                                          // the next position to read
+      uint32_t      head;                                // the producer's "head", as last read
+    };
+
+    T*               _slots;                                                       // the items
+    uint32_t         _mask;                                            // the capacity, minus 1
+    padded<producer> _producer;                                 // written by the producer only
+    padded<consumer> _consumer;                                 // written by the consumer only
+
+    spsc_ring(const spsc_ring&);                                                // not copyable
+    spsc_ring& operator=(const spsc_ring&);
+};
+
+// A ring for any number of producer and consumer threads
+
+template <class T> class mpmc_ring
+{
+  public:
+    mpmc_ring(const size_t capacity);
+    ~mpmc_ring() {delete[] _cells;}
+
+    bool   try_push(const T& item) {return push_batch(&item, 1) != 0;}
+    bool   try_pop(T& item)        {return pop_batch(&item, 1) != 0;}
+    size_t push_batch(const T* items, const size_t count);
+    size_t pop_batch(T* items, const size_t count);
+
+    size_t capacity() const {return (size_t)_mask + 1;}
+
+  private:
+    struct cell
+    {
+      pf_atomic32_t sequence;                        // the position that the cell is ready for
+      T             item;                                                           // the item
+    };
+
+    cell*                 _cells;                                                  // the slots
+    uint32_t              _mask;                                       // the capacity, minus 1
+    padded<pf_atomic32_t> _head;                                  // the next position to write
+    padded<pf_atomic32_t> _tail;                                   // the next position to read
+
+    mpmc_ring(const mpmc_ring&);                                                // not copyable
+    mpmc_ring& operator=(const mpmc_ring&);
+};
+
+// ============================================================================================
+// INLINE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+template <class T> spsc_ring<T>::spsc_ring
+(
+  const size_t capacity                                    // the least number of items to hold
+)
+
+/*
+This constructor creates an empty ring.
+
+PRECONDITIONS:
+"capacity" must be no greater than 0x40000000.
+
+POSTCONDITIONS:
+The ring is empty.
+*/
+
+{
+  _mask = 1;
+
+  while ((size_t)_mask + 1 < capacity)
+    _mask = (_mask << 1) | 1;
+
+  _slots = new T[(size_t)_mask + 1];
+
+  pf_atomic_store32(&_producer->head, 0, PF_MEMORY_ORDER_RELAXED);
+  pf_atomic_store32(&_consumer->tail, 0, PF_MEMORY_ORDER_RELAXED);
+  _producer->tail = 0;
+  _consumer->head = 0;
+}
+
+/*********************************************************************************************/
+
+template <class T> size_t spsc_ring<T>::push_batch
+(
+  const T*     items,                                                      // the items to push
+  const size_t count                                                      // how many there are
+)
+
+/*
+This function appends items to the ring.  Only one thread may call it (or "try_push()") at a
+time.
+
+PRECONDITIONS:
+"items" must point to "count" items.
+
+POSTCONDITIONS:
+The number of items that there was room for is returned (from 0 to "count").  Those items, in
+order, are at the back of the ring.
+*/
+
+{
+  const uint32_t head = (uint32_t)pf_atomic_load32(&_producer->head, PF_MEMORY_ORDER_RELAXED);
+  size_t         room = _mask + 1 - (head - _producer->tail);
+  size_t         index;
+
+  if (room < count)
+  {
+    _producer->tail = (uint32_t)pf_atomic_load32(&_consumer->tail, PF_MEMORY_ORDER_ACQUIRE);
+    room            = _mask + 1 - (head - _producer->tail);
+  }
+
+  if (room > count)
+    room = count;
+
+  for (index = 0; index < room; index++)
+    _slots[(head + index) & _mask] = items[index];
+
+  if (room > 0)
+    pf_atomic_store32(&_producer->head, (int32_t)(head + room), PF_MEMORY_ORDER_RELEASE);
+
+  return room;
+}
+
+/*********************************************************************************************/
+
+template <class T> size_t spsc_ring<T>::pop_batch
+(
+  T*           items,                                              // receives the items popped
+  const size_t count                                                   // the most items to pop
+)
+
+/*
+This function removes items from the front of the ring.  Only one thread may call it (or
+"try_pop()") at a time.
+
+PRECONDITIONS:
+"items" must have room for "count" items.
+
+POSTCONDITIONS:
+The number of items that were in the ring is returned (from 0 to "count"), and that many items
+have been copied to "items" in order.
+*/
+
+{
+  const uint32_t tail      = (uint32_t)pf_atomic_load32(&_consumer->tail,
+                                                        PF_MEMORY_ORDER_RELAXED);
+  size_t         available = _consumer->head - tail;
+  size_t         index;
+
+  if (available < count)
+  {
+    _consumer->head = (uint32_t)pf_atomic_load32(&_producer->head, PF_MEMORY_ORDER_ACQUIRE);
+    available       = _consumer->head - tail;
+  }
+
+  if (available > count)
+    available = count;
+
+  for (index = 0; index < available; index++)
+    items[index] = _slots[(tail + index) & _mask];
+
+  if (available > 0)
+    pf_atomic_store32(&_consumer->tail, (int32_t)(tail + available), PF_MEMORY_ORDER_RELEASE);
+
+  return available;
+}
+
+/*********************************************************************************************/
+
+template <class T> mpmc_ring<T>::mpmc_ring
+(
+  const size_t capacity                                    // the least number of items to hold
+)
+
+/*
+This constructor creates an empty ring.
+
+PRECONDITIONS:
+"capacity" must be no greater than 0x40000000.
+
+POSTCONDITIONS:
+The ring is empty.
+*/
+
+{
+  uint32_t index;
+
+  _mask = 1;
+
+  while ((size_t)_mask + 1 < capacity)
+    _mask = (_mask << 1) | 1;
+
+  _cells = new cell[(size_t)_mask + 1];
+
+  for (index = 0; index <= _mask; index++)
+    pf_atomic_store32(&_cells[index].sequence, (int32_t)index, PF_MEMORY_ORDER_RELAXED);
+
+  pf_atomic_store32(&*_head, 0, PF_MEMORY_ORDER_RELAXED);
+  pf_atomic_store32(&*_tail, 0, PF_MEMORY_ORDER_RELAXED);
+}
+
+/*********************************************************************************************/
+
+template <class T> size_t mpmc_ring<T>::push_batch
+(
+  const T*     items,                                                      // the items to push
+  const size_t count                                                      // how many there are
+)
+
+/*
+This function appends items to the ring.  Any number of threads may call it at once.
+
+PRECONDITIONS:
+"items" must point to "count" items.
+
+POSTCONDITIONS:
+The number of consecutive slots that were free is returned (from 0 to "count").  That many
+items have been appended to the ring in order, though other threads' items may be popped
+before this thread has finished copying them in.
+*/
+
+{
+  uint32_t head = (uint32_t)pf_atomic_load32(&*_head, PF_MEMORY_ORDER_RELAXED);
+  size_t   claimed;
+  size_t   index;
+
+  if (count == 0)
+    return 0;
+
+  // Claim the free slots at the back of the ring (the first one must be free, or the ring is
+  // full or another thread has claimed it)
+
+  for (;;)
+  {
+    const uint32_t sequence = (uint32_t)pf_atomic_load32(&_cells[head & _mask].sequence,
+                                                         PF_MEMORY_ORDER_ACQUIRE);
+    const int32_t  lap      = (int32_t)(sequence - head);
+
+    if (lap < 0)
+      return 0;
+
+    if (lap == 0)
+    {
+      claimed = 1;
+
+      while ((claimed < count) && (claimed <= _mask) &&
+             ((uint32_t)pf_atomic_load32(&_cells[(head + claimed) & _mask].sequence,
+                                         PF_MEMORY_ORDER_ACQUIRE) == head + claimed))
+      {
+        claimed++;
+      }
+
+      if (pf_atomic_cas32(&*_head, (int32_t*)&head, (int32_t)(head + claimed),
+                          PF_MEMORY_ORDER_RELAXED))
+      {
+        break;
+      }
+    }
+    else
+    {
+      head = (uint32_t)pf_atomic_load32(&*_head, PF_MEMORY_ORDER_RELAXED);
+    }
+  }
+
+  // Fill the slots and hand each one to the consumers
+
+  for (index = 0; index < claimed; index++)
+  {
+    cell& slot = _cells[(head + index) & _mask];
+
+    slot.item = items[index];
+    pf_atomic_store32(&slot.sequence, (int32_t)(head + index + 1), PF_MEMORY_ORDER_RELEASE);
+  }
+
+  return claimed;
+}
+
+/*********************************************************************************************/
+
+template <class T> size_t mpmc_ring<T>::pop_batch
+(
+  T*           items,                                              // receives the items popped
+  const size_t count                                                   // the most items to pop
+)
+
+/*
+This function removes items from the front of the ring.  Any number of threads may call it at
+once.
+
+PRECONDITIONS:
+"items" must have room for "count" items.
+
+POSTCONDITIONS:
+The number of consecutive items that were ready is returned (from 0 to "count"), and that many
+items have been copied to "items" in order.
+*/
+
+{
+  uint32_t tail = (uint32_t)pf_atomic_load32(&*_tail, PF_MEMORY_ORDER_RELAXED);
+  size_t   claimed;
+  size_t   index;
+
+  if (count == 0)
+    return 0;
+
+  // Claim the ready slots at the front of the ring (the first one must be ready, or the ring
+  // is empty or another thread has claimed it)
+
+  for (;;)
+  {
+    const uint32_t sequence = (uint32_t)pf_atomic_load32(&_cells[tail & _mask].sequence,
+                                                         PF_MEMORY_ORDER_ACQUIRE);
+    const int32_t  lap      = (int32_t)(sequence - (tail + 1));
+
+    if (lap < 0)
+      return 0;
+
+    if (lap == 0)
+    {
+      claimed = 1;
+
+      while ((claimed < count) && (claimed <= _mask) &&
+             ((uint32_t)pf_atomic_load32(&_cells[(tail + claimed) & _mask].sequence,
+                                         PF_MEMORY_ORDER_ACQUIRE) == tail + claimed + 1))
+      {
+        claimed++;
+      }
+
+      if (pf_atomic_cas32(&*_tail, (int32_t*)&tail, (int32_t)(tail + claimed),
+                          PF_MEMORY_ORDER_RELAXED))
+      {
+        break;
+      }
+    }
+    else
+    {
+      tail = (uint32_t)pf_atomic_load32(&*_tail, PF_MEMORY_ORDER_RELAXED);
+    }
+  }
+
+  // Empty the slots and hand each one back to the producers (a lap later)
+
+  for (index = 0; index < claimed; index++)
+  {
+    cell& slot = _cells[(tail + index) & _mask];
+
+    items[index] = slot.item;
+    pf_atomic_store32(&slot.sequence, (int32_t)(tail + index + _mask + 1),
+                      PF_MEMORY_ORDER_RELEASE);
+  }
+
+  return claimed;
+}
+
+}
+
+#endif
@@ -0,0 +1,1122 @@
+#ifndef PLATFORM_SIMD_H
+#define PLATFORM_SIMD_H
+
+// ============================================================================================
+//
+// simd.h -- Portable SIMD Vector Types
+//
+// ============================================================================================
+
+/*
+This header file defines "pf::vec<T, N>", a vector of "N" values of type "T" that's operated on
+as a whole, and "pf::mask<T, N>", the result of comparing two such vectors.  Where the compiler
+can generate SIMD instructions for a particular vector (see the "PF_SIMD_..." macros in
+"platform.h"), the vector is held in a SIMD register and every operation is a SIMD instruction
+(or a short sequence of them).  Everywhere else -- including on CPU's that "platform.h" doesn't
+know -- the vector is held in an ordinary array and every operation is a loop, which the
+compiler is free to vectorize by itself.  Code written with these types therefore compiles and
+runs correctly everywhere, and runs fast wherever it can.
+
+The following vectors are held in SIMD registers:
+
+  pf::vec<float, 4>, pf::vec<int32_t, 4>  SSE2 or NEON
+  pf::vec<float, 8>                       AVX
+  pf::vec<int32_t, 8>                     AVX2
+
+"pf::native_lanes<T>::value" is the number of lanes in the widest of these that's available for
+"T" (1 if none is), so that code can be written once for the best available width:
+
+  typedef pf::vec<float, pf::native_lanes<float>::value> floats;
+
+  float sumOf(const float* values, size_t count)   // "count" must be a multiple of the width
+  {
+    floats total(0.0f);
+
+    for (size_t i = 0; i < count; i += floats::lanes)
+      total += floats::loadu(values + i);
+
+    return pf::reduce_add(total);
+  }
+
+The following operations are available:
+
+  pf::vec<T, N>(x)          a vector with "x" in every lane
+  pf::vec<T, N>::load(p)    loads a vector from "p" (which must be aligned to the vector size)
+  pf::vec<T, N>::loadu(p)   loads a vector from "p" (which needn't be aligned)
+  v.store(p), v.storeu(p)   stores a vector (aligned and unaligned, respectively)
+  v[i]                      the value in lane "i" (slow -- intended for debugging)
+  +, -, *, +=, -=, *=       lane-by-lane arithmetic ("/" and "/=" are only available for float)
+  &, |, ^                   lane-by-lane bitwise operations (int32_t only)
+  ==, !=, <, <=, >, >=      lane-by-lane comparisons -- the result is a "pf::mask<T, N>"
+  &, |, ~                   combine masks
+  pf::any(m), pf::all(m)    whether any or all of a mask's lanes are set
+  pf::blend(m, a, b)        "a"'s lane where "m"'s lane is set, "b"'s lane where it isn't
+  pf::min(a, b), pf::max(a, b)
+                            lane-by-lane minimum and maximum
+  pf::shuffle<I0, I1, I2, I3>(v)
+                            rearranges each group of four lanes; lane "k" of a group receives
+                            lane "Ik" of the same group
+  pf::reduce_add(v), pf::reduce_min(v), pf::reduce_max(v)
+                            the sum, minimum or maximum of all lanes
+
+NOTE:  This header file requires a C++ compiler that supports namespaces and templates, and a
+<stdint.h> header file.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stdint.h>
+
+#include <platform.h>
+
+#if PF_SIMD_AVX
+  #include <immintrin.h>
+#elif PF_SIMD_SSE4_1
+  #include <smmintrin.h>
+#elif PF_SIMD_SSE2
+  #include <emmintrin.h>
+#elif PF_SIMD_NEON
+  #include <arm_neon.h>
+#endif
+
+namespace pf
+{
+
+// ============================================================================================
+// GENERIC CLASS DEFINITIONS
+// ============================================================================================
+
+template <class T, int N> class mask
+{
+  public:
+    enum {lanes = N};
+
+    mask() {}
+
+    explicit mask(const bool value)                        // a mask with "value" in every lane
+    {
+      for (int i = 0; i < N; i++)
+        _lane[i] = value;
+    }
+
+    bool  operator[](const int i) const {return _lane[i];}
+    bool& operator[](const int i)       {return _lane[i];}
+
+  private:
+    bool _lane[N];                                                         // the lanes' values
+};
+
+/*********************************************************************************************/
+
+template <class T, int N> class vec
+{
+  public:
+    typedef T value_type;
+    enum {lanes = N};
+
+    vec() {}
+
+    explicit vec(const T value)                         // a vector with "value" in every lane
+    {
+      for (int i = 0; i < N; i++)
+        _lane[i] = value;
+    }
+
+    static vec load(const T* source)                              // load from aligned memory
+    {
+      return loadu(source);
+    }
+
+    static vec loadu(const T* source)                           // load from unaligned memory
+    {
+      vec result;
+
+      for (int i = 0; i < N; i++)
+        result._lane[i] = source[i];
+
+      return result;
+    }
+
+    void store(T* target) const                                    // store to aligned memory
+    {
+      storeu(target);
+    }
+
+    void storeu(T* target) const                                 // store to unaligned memory
+    {
+      for (int i = 0; i < N; i++)
+        target[i] = _lane[i];
+    }
+
+    T  operator[](const int i) const {return _lane[i];}
+    T& operator[](const int i)       {return _lane[i];}
+
+  private:
+    T _lane[N];                                                            // the lanes' values
+};
+
+/*********************************************************************************************/
+
+template <class T> struct native_lanes
+{
+  enum {value = 1};
+};
+
+// ============================================================================================
+// GENERIC FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*
+Each of these applies an operator or function lane by lane.  Where a vector is held in a SIMD
+register, a (non-template) overload defined later on by this file is chosen instead.
+*/
+
+#define PF_SIMD_GENERIC_ARITHMETIC(op)                                                      \
+  template <class T, int N> inline vec<T, N> operator op(const vec<T, N>& a,                \
+                                                         const vec<T, N>& b)                \
+  {                                                                                         \
+    vec<T, N> result;                                                                       \
+                                                                                            \
+    for (int i = 0; i < N; i++)                                                             \
+      result[i] = a[i] op b[i];                                                             \
+                                                                                            \
+    return result;                                                                          \
+  }
+
+#define PF_SIMD_GENERIC_COMPARISON(op)                                                      \
+  template <class T, int N> inline mask<T, N> operator op(const vec<T, N>& a,               \
+                                                          const vec<T, N>& b)               \
+  {                                                                                         \
+    mask<T, N> result;                                                                      \
+                                                                                            \
+    for (int i = 0; i < N; i++)                                                             \
+      result[i] = (a[i] op b[i]);                                                           \
+                                                                                            \
+    return result;                                                                          \
+  }
+
+#define PF_SIMD_GENERIC_LOGIC(op)                                                           \
+  template <class T, int N> inline mask<T, N> operator op(const mask<T, N>& a,              \
+                                                          const mask<T, N>& b)              \
+  {                                                                                         \
+    mask<T, N> result;                                                                      \
+                                                                                            \
+    for (int i = 0; i < N; i++)                                                             \
+      result[i] = (a[i] op b[i]);                                                           \
+                                                                                            \
+    return result;                                                                          \
+  }
+
+PF_SIMD_GENERIC_ARITHMETIC(+)
+PF_SIMD_GENERIC_ARITHMETIC(-)
+PF_SIMD_GENERIC_ARITHMETIC(*)
+PF_SIMD_GENERIC_ARITHMETIC(/)
+PF_SIMD_GENERIC_ARITHMETIC(&)
+PF_SIMD_GENERIC_ARITHMETIC(|)
+PF_SIMD_GENERIC_ARITHMETIC(^)
+
+PF_SIMD_GENERIC_COMPARISON(==)
+PF_SIMD_GENERIC_COMPARISON(!=)
+PF_SIMD_GENERIC_COMPARISON(<)
+PF_SIMD_GENERIC_COMPARISON(<=)
+PF_SIMD_GENERIC_COMPARISON(>)
+PF_SIMD_GENERIC_COMPARISON(>=)
+
+PF_SIMD_GENERIC_LOGIC(&)
+PF_SIMD_GENERIC_LOGIC(|)
+
+#undef PF_SIMD_GENERIC_ARITHMETIC
+#undef PF_SIMD_GENERIC_COMPARISON
+#undef PF_SIMD_GENERIC_LOGIC
+
+/*********************************************************************************************/
+
+template <class T, int N> inline vec<T, N>& operator+=(vec<T, N>& a, const vec<T, N>& b)
+{
+  return a = a + b;
+}
+
+template <class T, int N> inline vec<T, N>& operator-=(vec<T, N>& a, const vec<T, N>& b)
+{
+  return a = a - b;
+}
+
+template <class T, int N> inline vec<T, N>& operator*=(vec<T, N>& a, const vec<T, N>& b)
+{
+  return a = a * b;
+}
+
+template <class T, int N> inline vec<T, N>& operator/=(vec<T, N>& a, const vec<T, N>& b)
+{
+  return a = a / b;
+}
+
+/*********************************************************************************************/
+
+template <class T, int N> inline mask<T, N> operator~(const mask<T, N>& m)
+{
+  mask<T, N> result;
+
+  for (int i = 0; i < N; i++)
+    result[i] = !m[i];
+
+  return result;
+}
+
+template <class T, int N> inline bool any(const mask<T, N>& m)
+{
+  for (int i = 0; i < N; i++)
+    if (m[i])
+      return true;
+
+  return false;
+}
+
+template <class T, int N> inline bool all(const mask<T, N>& m)
+{
+  for (int i = 0; i < N; i++)
+    if (!m[i])
+      return false;
+
+  return true;
+}
+
+/*********************************************************************************************/
+
+template <class T, int N> inline vec<T, N> blend
+(
+  const mask<T, N>& m,                                                // selects "a" or "b"
+  const vec<T, N>&  a,                                      // the lanes selected by set lanes
+  const vec<T, N>&  b                                     // the lanes selected by clear lanes
+)
+{
+  vec<T, N> result;
+
+  for (int i = 0; i < N; i++)
+    result[i] = (m[i] ? a[i] : b[i]);
+
+  return result;
+}
+
+template <class T, int N> inline vec<T, N> min(const vec<T, N>& a, const vec<T, N>& b)
+{
+  return blend(b < a, b, a);
+}
+
+template <class T, int N> inline vec<T, N> max(const vec<T, N>& a, const vec<T, N>& b)
+{
+  return blend(b > a, b, a);
+}
+
+/*********************************************************************************************/
+
+template <int I0, int I1, int I2, int I3, class T, int N> inline vec<T, N> shuffle
+(
+  const vec<T, N>& v                                   // the vector to rearrange ("N" must be
+)                                                      // a multiple of 4)
+{
+  vec<T, N> result;
+
+  for (int group = 0; group < N; group += 4)
+  {
+    result[group + 0] = v[group + I0];
+    result[group + 1] = v[group + I1];
+    result[group + 2] = v[group + I2];
+    result[group + 3] = v[group + I3];
+  }
+
+  return result;
+}
+
+/*********************************************************************************************/
+
+template <class T, int N> inline T reduce_add(const vec<T, N>& v)
+{
+  T result = v[0];
+
+  for (int i = 1; i < N; i++)
+    result = result + v[i];
+
+  return result;
+}
+
+template <class T, int N> inline T reduce_min(const vec<T, N>& v)
+{
+  T result = v[0];
+
+  for (int i = 1; i < N; i++)
+    if (v[i] < result)
+      result = v[i];
+
+  return result;
+}
+
+template <class T, int N> inline T reduce_max(const vec<T, N>& v)
+{
+  T result = v[0];
+
+  for (int i = 1; i < N; i++)
+    if (v[i] > result)
+      result = v[i];
+
+  return result;
+}
+
+// ============================================================================================
+// SSE2 SPECIALIZATIONS (4 x float, 4 x int32_t)
+// ============================================================================================
+
+#if PF_SIMD_SSE2
+
+template <> class mask<float, 4>
+{
+  public:
+    enum {lanes = 4};
+
+    mask() {}
+    mask(const __m128 value): _value(value) {}
+    explicit mask(const bool value):
+      _value(_mm_castsi128_ps(_mm_set1_epi32(value ? -1 : 0))) {}
+
+    bool operator[](const int i) const {return ((_mm_movemask_ps(_value) >> i) & 1) != 0;}
+    operator __m128() const            {return _value;}
+
+  private:
+    __m128 _value;                                    // all bits set in lanes that are set
+};
+
+template <> class mask<int32_t, 4>
+{
+  public:
+    enum {lanes = 4};
+
+    mask() {}
+    mask(const __m128i value): _value(value) {}
+    explicit mask(const bool value): _value(_mm_set1_epi32(value ? -1 : 0)) {}
+
+    bool operator[](const int i) const
+    {
+      return ((_mm_movemask_ps(_mm_castsi128_ps(_value)) >> i) & 1) != 0;
+    }
+
+    operator __m128i() const {return _value;}
+
+  private:
+    __m128i _value;                                   // all bits set in lanes that are set
+};
+
+/*********************************************************************************************/
+
+template <> class vec<float, 4>
+{
+  public:
+    typedef float value_type;
+    enum {lanes = 4};
+
+    vec() {}
+    vec(const __m128 value): _value(value) {}
+    explicit vec(const float value): _value(_mm_set1_ps(value)) {}
+
+    static vec load(const float* source)  {return _mm_load_ps(source);}
+    static vec loadu(const float* source) {return _mm_loadu_ps(source);}
+    void store(float* target) const       {_mm_store_ps(target, _value);}
+    void storeu(float* target) const      {_mm_storeu_ps(target, _value);}
+
+    float operator[](const int i) const
+    {
+      float values[4];
+
+      _mm_storeu_ps(values, _value);
+      return values[i];
+    }
+
+    operator __m128() const {return _value;}
+
+  private:
+    __m128 _value;                                                        // the lanes' values
+};
+
+template <> class vec<int32_t, 4>
+{
+  public:
+    typedef int32_t value_type;
+    enum {lanes = 4};
+
+    vec() {}
+    vec(const __m128i value): _value(value) {}
+    explicit vec(const int32_t value): _value(_mm_set1_epi32(value)) {}
+
+    static vec load(const int32_t* source)  {return _mm_load_si128((const __m128i*)source);}
+    static vec loadu(const int32_t* source) {return _mm_loadu_si128((const __m128i*)source);}
+    void store(int32_t* target) const       {_mm_store_si128((__m128i*)target, _value);}
+    void storeu(int32_t* target) const      {_mm_storeu_si128((__m128i*)target, _value);}
+
+    int32_t operator[](const int i) const
+    {
+      int32_t values[4];
+
+      _mm_storeu_si128((__m128i*)values, _value);
+      return values[i];
+    }
+
+    operator __m128i() const {return _value;}
+
+  private:
+    __m128i _value;                                                       // the lanes' values
+};
+
+template <> struct native_lanes<float>   {enum {value = (PF_SIMD_AVX  ? 8 : 4)};};
+template <> struct native_lanes<int32_t> {enum {value = (PF_SIMD_AVX2 ? 8 : 4)};};
+
+/*********************************************************************************************/
+
+typedef vec<float, 4>    Pf4f;
+typedef vec<int32_t, 4>  Pf4i;
+typedef mask<float, 4>   Pf4fm;
+typedef mask<int32_t, 4> Pf4im;
+
+inline Pf4f operator+(const Pf4f& a, const Pf4f& b) {return _mm_add_ps(a, b);}
+inline Pf4f operator-(const Pf4f& a, const Pf4f& b) {return _mm_sub_ps(a, b);}
+inline Pf4f operator*(const Pf4f& a, const Pf4f& b) {return _mm_mul_ps(a, b);}
+inline Pf4f operator/(const Pf4f& a, const Pf4f& b) {return _mm_div_ps(a, b);}
+
+inline Pf4fm operator==(const Pf4f& a, const Pf4f& b) {return _mm_cmpeq_ps(a, b);}
+inline Pf4fm operator!=(const Pf4f& a, const Pf4f& b) {return _mm_cmpneq_ps(a, b);}
+inline Pf4fm operator< (const Pf4f& a, const Pf4f& b) {return _mm_cmplt_ps(a, b);}
+inline Pf4fm operator<=(const Pf4f& a, const Pf4f& b) {return _mm_cmple_ps(a, b);}
+inline Pf4fm operator> (const Pf4f& a, const Pf4f& b) {return _mm_cmpgt_ps(a, b);}
+inline Pf4fm operator>=(const Pf4f& a, const Pf4f& b) {return _mm_cmpge_ps(a, b);}
+
+inline Pf4fm operator&(const Pf4fm& a, const Pf4fm& b) {return _mm_and_ps(a, b);}
+inline Pf4fm operator|(const Pf4fm& a, const Pf4fm& b) {return _mm_or_ps(a, b);}
+inline Pf4fm operator~(const Pf4fm& m)                 {return _mm_xor_ps(m, Pf4fm(true));}
+inline bool  any(const Pf4fm& m)                       {return _mm_movemask_ps(m) != 0;}
+inline bool  all(const Pf4fm& m)                       {return _mm_movemask_ps(m) == 0x0f;}
+
+inline Pf4f blend(const Pf4fm& m, const Pf4f& a, const Pf4f& b)
+{
+  #if PF_SIMD_SSE4_1
+    return _mm_blendv_ps(b, a, m);
+  #else
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+  #endif
+}
+
+inline Pf4f min(const Pf4f& a, const Pf4f& b) {return _mm_min_ps(a, b);}
+inline Pf4f max(const Pf4f& a, const Pf4f& b) {return _mm_max_ps(a, b);}
+
+template <int I0, int I1, int I2, int I3> inline Pf4f shuffle(const Pf4f& v)
+{
+  return _mm_shuffle_ps(v, v, _MM_SHUFFLE(I3, I2, I1, I0));
+}
+
+inline float reduce_add(const Pf4f& v)
+{
+  const __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+
+  return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+inline float reduce_min(const Pf4f& v)
+{
+  const __m128 pairs = _mm_min_ps(v, _mm_movehl_ps(v, v));
+
+  return _mm_cvtss_f32(_mm_min_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+inline float reduce_max(const Pf4f& v)
+{
+  const __m128 pairs = _mm_max_ps(v, _mm_movehl_ps(v, v));
+
+  return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+/*********************************************************************************************/
+
+inline Pf4i operator+(const Pf4i& a, const Pf4i& b) {return _mm_add_epi32(a, b);}
+inline Pf4i operator-(const Pf4i& a, const Pf4i& b) {return _mm_sub_epi32(a, b);}
+inline Pf4i operator&(const Pf4i& a, const Pf4i& b) {return _mm_and_si128(a, b);}
+inline Pf4i operator|(const Pf4i& a, const Pf4i& b) {return _mm_or_si128(a, b);}
+inline Pf4i operator^(const Pf4i& a, const Pf4i& b) {return _mm_xor_si128(a, b);}
+
+inline Pf4i operator*(const Pf4i& a, const Pf4i& b)
+{
+  #if PF_SIMD_SSE4_1
+    return _mm_mullo_epi32(a, b);
+  #else
+    // SSE2 can only multiply the even lanes, so the odd lanes are shifted down and multiplied
+    // separately, then the low halves of the products are interleaved.
+
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0, 0, 2, 0)));
+  #endif
+}
+
+inline Pf4im operator&(const Pf4im& a, const Pf4im& b) {return _mm_and_si128(a, b);}
+inline Pf4im operator|(const Pf4im& a, const Pf4im& b) {return _mm_or_si128(a, b);}
+inline Pf4im operator~(const Pf4im& m)                 {return _mm_xor_si128(m, Pf4im(true));}
+
+inline bool any(const Pf4im& m) {return _mm_movemask_ps(_mm_castsi128_ps(m)) != 0;}
+inline bool all(const Pf4im& m) {return _mm_movemask_ps(_mm_castsi128_ps(m)) == 0x0f;}
+
+inline Pf4im operator==(const Pf4i& a, const Pf4i& b) {return _mm_cmpeq_epi32(a, b);}
+inline Pf4im operator< (const Pf4i& a, const Pf4i& b) {return _mm_cmplt_epi32(a, b);}
+inline Pf4im operator> (const Pf4i& a, const Pf4i& b) {return _mm_cmpgt_epi32(a, b);}
+inline Pf4im operator!=(const Pf4i& a, const Pf4i& b) {return ~(a == b);}
+inline Pf4im operator<=(const Pf4i& a, const Pf4i& b) {return ~(a > b);}
+inline Pf4im operator>=(const Pf4i& a, const Pf4i& b) {return ~(a < b);}
+
+inline Pf4i blend(const Pf4im& m, const Pf4i& a, const Pf4i& b)
+{
+  #if PF_SIMD_SSE4_1
+    return _mm_blendv_epi8(b, a, m);
+  #else
+    return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+  #endif
+}
+
+inline Pf4i min(const Pf4i& a, const Pf4i& b)
+{
+  #if PF_SIMD_SSE4_1
+    return _mm_min_epi32(a, b);
+  #else
+    return blend(b < a, b, a);
+  #endif
+}
+
+inline Pf4i max(const Pf4i& a, const Pf4i& b)
+{
+  #if PF_SIMD_SSE4_1
+    return _mm_max_epi32(a, b);
+  #else
+    return blend(b > a, b, a);
+  #endif
+}
+
+template <int I0, int I1, int I2, int I3> inline Pf4i shuffle(const Pf4i& v)
+{
+  return _mm_shuffle_epi32(v, _MM_SHUFFLE(I3, I2, I1, I0));
+}
+
+inline int32_t reduce_add(const Pf4i& v)
+{
+  const Pf4i pairs = v + shuffle<2, 3, 0, 1>(v);
+
+  return _mm_cvtsi128_si32(pairs + shuffle<1, 0, 3, 2>(pairs));
+}
+
+inline int32_t reduce_min(const Pf4i& v)
+{
+  const Pf4i pairs = min(v, shuffle<2, 3, 0, 1>(v));
+
+  return _mm_cvtsi128_si32(min(pairs, shuffle<1, 0, 3, 2>(pairs)));
+}
+
+inline int32_t reduce_max(const Pf4i& v)
+{
+  const Pf4i pairs = max(v, shuffle<2, 3, 0, 1>(v));
+
+  return _mm_cvtsi128_si32(max(pairs, shuffle<1, 0, 3, 2>(pairs)));
+}
+
+#endif
+
+// ============================================================================================
+// NEON SPECIALIZATIONS (4 x float, 4 x int32_t)
+// ============================================================================================
+
+#if PF_SIMD_NEON
+
+template <> class mask<float, 4>
+{
+  public:
+    enum {lanes = 4};
+
+    mask() {}
+    mask(const uint32x4_t value): _value(value) {}
+    explicit mask(const bool value): _value(vdupq_n_u32(value ? 0xffffffffU : 0)) {}
+
+    bool operator[](const int i) const
+    {
+      uint32_t values[4];
+
+      vst1q_u32(values, _value);
+      return values[i] != 0;
+    }
+
+    operator uint32x4_t() const {return _value;}
+
+  private:
+    uint32x4_t _value;                                // all bits set in lanes that are set
+};
+
+template <> class mask<int32_t, 4>
+{
+  public:
+    enum {lanes = 4};
+
+    mask() {}
+    mask(const uint32x4_t value): _value(value) {}
+    explicit mask(const bool value): _value(vdupq_n_u32(value ? 0xffffffffU : 0)) {}
+
+    bool operator[](const int i) const
+    {
+      uint32_t values[4];
+
+      vst1q_u32(values, _value);
+      return values[i] != 0;
+    }
+
+    operator uint32x4_t() const {return _value;}
+
+  private:
+    uint32x4_t _value;                                // all bits set in lanes that are set
+};
+
+/*********************************************************************************************/
+
+template <> class vec<float, 4>
+{
+  public:
+    typedef float value_type;
+    enum {lanes = 4};
+
+    vec() {}
+    vec(const float32x4_t value): _value(value) {}
+    explicit vec(const float value): _value(vdupq_n_f32(value)) {}
+
+    static vec load(const float* source)  {return vld1q_f32(source);}
+    static vec loadu(const float* source) {return vld1q_f32(source);}
+    void store(float* target) const       {vst1q_f32(target, _value);}
+    void storeu(float* target) const      {vst1q_f32(target, _value);}
+
+    float operator[](const int i) const
+    {
+      float values[4];
+
+      vst1q_f32(values, _value);
+      return values[i];
+    }
+
+    operator float32x4_t() const {return _value;}
+
+  private:
+    float32x4_t _value;                                                   // the lanes' values
+};
+
+template <> class vec<int32_t, 4>
+{
+  public:
+    typedef int32_t value_type;
+    enum {lanes = 4};
+
+    vec() {}
+    vec(const int32x4_t value): _value(value) {}
+    explicit vec(const int32_t value): _value(vdupq_n_s32(value)) {}
+
+    static vec load(const int32_t* source)  {return vld1q_s32(source);}
+    static vec loadu(const int32_t* source) {return vld1q_s32(source);}
+    void store(int32_t* target) const       {vst1q_s32(target, _value);}
+    void storeu(int32_t* target) const      {vst1q_s32(target, _value);}
+
+    int32_t operator[](const int i) const
+    {
+      int32_t values[4];
+
+      vst1q_s32(values, _value);
+      return values[i];
+    }
+
+    operator int32x4_t() const {return _value;}
+
+  private:
+    int32x4_t _value;                                                     // the lanes' values
+};
+
+template <> struct native_lanes<float>   {enum {value = 4};};
+template <> struct native_lanes<int32_t> {enum {value = 4};};
+
+/*********************************************************************************************/
+
+typedef vec<float, 4>    Pf4f;
+typedef vec<int32_t, 4>  Pf4i;
+typedef mask<float, 4>   Pf4fm;
+typedef mask<int32_t, 4> Pf4im;
+
+inline Pf4f operator+(const Pf4f& a, const Pf4f& b) {return vaddq_f32(a, b);}
+inline Pf4f operator-(const Pf4f& a, const Pf4f& b) {return vsubq_f32(a, b);}
+inline Pf4f operator*(const Pf4f& a, const Pf4f& b) {return vmulq_f32(a, b);}
+
+inline Pf4f operator/(const Pf4f& a, const Pf4f& b)
+{
+  #if (PF_CPU == PF_ARM_AARCH64)
+    return vdivq_f32(a, b);
+  #else
+    // 32-bit NEON has no division, so the reciprocal estimate is refined by two Newton-Raphson
+    // steps (which is accurate to within a unit or two in the last place).
+
+    float32x4_t reciprocal = vrecpeq_f32(b);
+
+    reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    return vmulq_f32(a, reciprocal);
+  #endif
+}
+
+inline Pf4fm operator==(const Pf4f& a, const Pf4f& b) {return vceqq_f32(a, b);}
+inline Pf4fm operator!=(const Pf4f& a, const Pf4f& b) {return vmvnq_u32(vceqq_f32(a, b));}
+inline Pf4fm operator< (const Pf4f& a, const Pf4f& b) {return vcltq_f32(a, b);}
+inline Pf4fm operator<=(const Pf4f& a, const Pf4f& b) {return vcleq_f32(a, b);}
+inline Pf4fm operator> (const Pf4f& a, const Pf4f& b) {return vcgtq_f32(a, b);}
+inline Pf4fm operator>=(const Pf4f& a, const Pf4f& b) {return vcgeq_f32(a, b);}
+
+inline Pf4fm operator&(const Pf4fm& a, const Pf4fm& b) {return vandq_u32(a, b);}
+inline Pf4fm operator|(const Pf4fm& a, const Pf4fm& b) {return vorrq_u32(a, b);}
+inline Pf4fm operator~(const Pf4fm& m)                 {return vmvnq_u32(m);}
+
+inline bool any(const Pf4fm& m)
+{
+  const uint32x2_t halves = vorr_u32(vget_low_u32(m), vget_high_u32(m));
+
+  return (vget_lane_u32(halves, 0) | vget_lane_u32(halves, 1)) != 0;
+}
+
+inline bool all(const Pf4fm& m)
+{
+  const uint32x2_t halves = vand_u32(vget_low_u32(m), vget_high_u32(m));
+
+  return (vget_lane_u32(halves, 0) & vget_lane_u32(halves, 1)) != 0;
+}
+
+inline Pf4f blend(const Pf4fm& m, const Pf4f& a, const Pf4f& b) {return vbslq_f32(m, a, b);}
+
+inline Pf4f min(const Pf4f& a, const Pf4f& b) {return vminq_f32(a, b);}
+inline Pf4f max(const Pf4f& a, const Pf4f& b) {return vmaxq_f32(a, b);}
+
+template <int I0, int I1, int I2, int I3> inline Pf4f shuffle(const Pf4f& v)
+{
+  float32x4_t result = vdupq_n_f32(vgetq_lane_f32(v, I0));
+
+  result = vsetq_lane_f32(vgetq_lane_f32(v, I1), result, 1);
+  result = vsetq_lane_f32(vgetq_lane_f32(v, I2), result, 2);
+  return vsetq_lane_f32(vgetq_lane_f32(v, I3), result, 3);
+}
+
+inline float reduce_add(const Pf4f& v)
+{
+  const float32x2_t pairs = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+
+  return vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+}
+
+inline float reduce_min(const Pf4f& v)
+{
+  const float32x2_t pairs = vmin_f32(vget_low_f32(v), vget_high_f32(v));
+
+  return vget_lane_f32(vpmin_f32(pairs, pairs), 0);
+}
+
+inline float reduce_max(const Pf4f& v)
+{
+  const float32x2_t pairs = vmax_f32(vget_low_f32(v), vget_high_f32(v));
+
+  return vget_lane_f32(vpmax_f32(pairs, pairs), 0);
+}
+
+/*********************************************************************************************/
+
+inline Pf4i operator+(const Pf4i& a, const Pf4i& b) {return vaddq_s32(a, b);}
+inline Pf4i operator-(const Pf4i& a, const Pf4i& b) {return vsubq_s32(a, b);}
+inline Pf4i operator*(const Pf4i& a, const Pf4i& b) {return vmulq_s32(a, b);}
+inline Pf4i operator&(const Pf4i& a, const Pf4i& b) {return vandq_s32(a, b);}
+inline Pf4i operator|(const Pf4i& a, const Pf4i& b) {return vorrq_s32(a, b);}
+inline Pf4i operator^(const Pf4i& a, const Pf4i& b) {return veorq_s32(a, b);}
+
+inline Pf4im operator==(const Pf4i& a, const Pf4i& b) {return vceqq_s32(a, b);}
+inline Pf4im operator!=(const Pf4i& a, const Pf4i& b) {return vmvnq_u32(vceqq_s32(a, b));}
+inline Pf4im operator< (const Pf4i& a, const Pf4i& b) {return vcltq_s32(a, b);}
+inline Pf4im operator<=(const Pf4i& a, const Pf4i& b) {return vcleq_s32(a, b);}
+inline Pf4im operator> (const Pf4i& a, const Pf4i& b) {return vcgtq_s32(a, b);}
+inline Pf4im operator>=(const Pf4i& a, const Pf4i& b) {return vcgeq_s32(a, b);}
+
+inline Pf4im operator&(const Pf4im& a, const Pf4im& b) {return vandq_u32(a, b);}
+inline Pf4im operator|(const Pf4im& a, const Pf4im& b) {return vorrq_u32(a, b);}
+inline Pf4im operator~(const Pf4im& m)                 {return vmvnq_u32(m);}
+
+inline bool any(const Pf4im& m) {return any(Pf4fm((uint32x4_t)m));}
+inline bool all(const Pf4im& m) {return all(Pf4fm((uint32x4_t)m));}
+
+inline Pf4i blend(const Pf4im& m, const Pf4i& a, const Pf4i& b) {return vbslq_s32(m, a, b);}
+
+inline Pf4i min(const Pf4i& a, const Pf4i& b) {return vminq_s32(a, b);}
+inline Pf4i max(const Pf4i& a, const Pf4i& b) {return vmaxq_s32(a, b);}
+
+template <int I0, int I1, int I2, int I3> inline Pf4i shuffle(const Pf4i& v)
+{
+  int32x4_t result = vdupq_n_s32(vgetq_lane_s32(v, I0));
+
+  result = vsetq_lane_s32(vgetq_lane_s32(v, I1), result, 1);
+  result = vsetq_lane_s32(vgetq_lane_s32(v, I2), result, 2);
+  return vsetq_lane_s32(vgetq_lane_s32(v, I3), result, 3);
+}
+
+inline int32_t reduce_add(const Pf4i& v)
+{
+  const int32x2_t pairs = vadd_s32(vget_low_s32(v), vget_high_s32(v));
+
+  return vget_lane_s32(vpadd_s32(pairs, pairs), 0);
+}
+
+inline int32_t reduce_min(const Pf4i& v)
+{
+  const int32x2_t pairs = vmin_s32(vget_low_s32(v), vget_high_s32(v));
+
+  return vget_lane_s32(vpmin_s32(pairs, pairs), 0);
+}
+
+inline int32_t reduce_max(const Pf4i& v)
+{
+  const int32x2_t pairs = vmax_s32(vget_low_s32(v), vget_high_s32(v));
+
+  return vget_lane_s32(vpmax_s32(pairs, pairs), 0);
+}
+
+#endif
+
+// ============================================================================================
+// AVX SPECIALIZATIONS (8 x float)
+// ============================================================================================
+
+#if PF_SIMD_AVX
+
+template <> class mask<float, 8>
+{
+  public:
+    enum {lanes = 8};
+
+    mask() {}
+    mask(const __m256 value): _value(value) {}
+
+    explicit mask(const bool value):
+      _value(_mm256_castsi256_ps(_mm256_set1_epi32(value ? -1 : 0))) {}
+
+    bool operator[](const int i) const {return ((_mm256_movemask_ps(_value) >> i) & 1) != 0;}
+    operator __m256() const            {return _value;}
+
+  private:
+    __m256 _value;                                    // all bits set in lanes that are set
+};
+
+template <> class vec<float, 8>
+{
+  public:
+    typedef float value_type;
+    enum {lanes = 8};
+
+    vec() {}
+    vec(const __m256 value): _value(value) {}
+    explicit vec(const float value): _value(_mm256_set1_ps(value)) {}
+
+    static vec load(const float* source)  {return _mm256_load_ps(source);}
+    static vec loadu(const float* source) {return _mm256_loadu_ps(source);}
+    void store(float* target) const       {_mm256_store_ps(target, _value);}
+    void storeu(float* target) const      {_mm256_storeu_ps(target, _value);}
+
+    float operator[](const int i) const
+    {
+      float values[8];
+
+      _mm256_storeu_ps(values, _value);
+      return values[i];
+    }
+
+    operator __m256() const {return _value;}
+
+  private:
+    __m256 _value;                                                        // the lanes' values
+};
+
+/*********************************************************************************************/
+
+typedef vec<float, 8>  Pf8f;
+typedef mask<float, 8> Pf8fm;
+
+inline Pf8f operator+(const Pf8f& a, const Pf8f& b) {return _mm256_add_ps(a, b);}
+inline Pf8f operator-(const Pf8f& a, const Pf8f& b) {return _mm256_sub_ps(a, b);}
+inline Pf8f operator*(const Pf8f& a, const Pf8f& b) {return _mm256_mul_ps(a, b);}
+inline Pf8f operator/(const Pf8f& a, const Pf8f& b) {return _mm256_div_ps(a, b);}
+
+inline Pf8fm operator==(const Pf8f& a, const Pf8f& b) {return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);}
+inline Pf8fm operator< (const Pf8f& a, const Pf8f& b) {return _mm256_cmp_ps(a, b, _CMP_LT_OQ);}
+inline Pf8fm operator<=(const Pf8f& a, const Pf8f& b) {return _mm256_cmp_ps(a, b, _CMP_LE_OQ);}
+inline Pf8fm operator> (const Pf8f& a, const Pf8f& b) {return _mm256_cmp_ps(a, b, _CMP_GT_OQ);}
+inline Pf8fm operator>=(const Pf8f& a, const Pf8f& b) {return _mm256_cmp_ps(a, b, _CMP_GE_OQ);}
+
+inline Pf8fm operator&(const Pf8fm& a, const Pf8fm& b) {return _mm256_and_ps(a, b);}
+inline Pf8fm operator|(const Pf8fm& a, const Pf8fm& b) {return _mm256_or_ps(a, b);}
+inline Pf8fm operator~(const Pf8fm& m)                 {return _mm256_xor_ps(m, Pf8fm(true));}
+inline bool  any(const Pf8fm& m)                       {return _mm256_movemask_ps(m) != 0;}
+inline bool  all(const Pf8fm& m)                       {return _mm256_movemask_ps(m) == 0xff;}
+
+inline Pf8fm operator!=(const Pf8f& a, const Pf8f& b) {return ~(a == b);}
+
+inline Pf8f blend(const Pf8fm& m, const Pf8f& a, const Pf8f& b)
+{
+  return _mm256_blendv_ps(b, a, m);
+}
+
+inline Pf8f min(const Pf8f& a, const Pf8f& b) {return _mm256_min_ps(a, b);}
+inline Pf8f max(const Pf8f& a, const Pf8f& b) {return _mm256_max_ps(a, b);}
+
+template <int I0, int I1, int I2, int I3> inline Pf8f shuffle(const Pf8f& v)
+{
+  return _mm256_permute_ps(v, _MM_SHUFFLE(I3, I2, I1, I0));
+}
+
+inline float reduce_add(const Pf8f& v)
+{
+  return reduce_add(Pf4f(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1))));
+}
+
+inline float reduce_min(const Pf8f& v)
+{
+  return reduce_min(Pf4f(_mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1))));
+}
+
+inline float reduce_max(const Pf8f& v)
+{
+  return reduce_max(Pf4f(_mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1))));
+}
+
+#endif
+
+// ============================================================================================
+// AVX2 SPECIALIZATIONS (8 x int32_t)
+// ============================================================================================
+
+#if PF_SIMD_AVX2
+
+template <> class mask<int32_t, 8>
+{
+  public:
+    enum {lanes = 8};
+
+    mask() {}
+    mask(const __m256i value): _value(value) {}
+    explicit mask(const bool value): _value(_mm256_set1_epi32(value ? -1 : 0)) {}
+
+    bool operator[](const int i) const
+    {
+      return ((_mm256_movemask_ps(_mm256_castsi256_ps(_value)) >> i) & 1) != 0;
+    }
+
+    operator __m256i() const {return _value;}
+
+  private:
+    __m256i _value;                                   // all bits set in lanes that are set
+};
+
+template <> class vec<int32_t, 8>
+{
+  public:
+    typedef int32_t value_type;
+    enum {lanes = 8};
+
+    vec() {}
+    vec(const __m256i value): _value(value) {}
+    explicit vec(const int32_t value): _value(_mm256_set1_epi32(value)) {}
+
+    static vec load(const int32_t* source) {return _mm256_load_si256((const __m256i*)source);}
+    void store(int32_t* target) const      {_mm256_store_si256((__m256i*)target, _value);}
+
+    static vec loadu(const int32_t* source)
+    {
+      return _mm256_loadu_si256((const __m256i*)source);
+    }
+
+    void storeu(int32_t* target) const {_mm256_storeu_si256((__m256i*)target, _value);}
+
+    int32_t operator[](const int i) const
+    {
+      int32_t values[8];
+
+      _mm256_storeu_si256((__m256i*)values, _value);
+      return values[i];
+    }
+
+    operator __m256i() const {return _value;}
+
+  private:
+    __m256i _value;                                                       // the lanes' values
+};
+
+/*********************************************************************************************/
+
+typedef vec<int32_t, 8>  Pf8i;
+typedef mask<int32_t, 8> Pf8im;
+
+inline Pf8i operator+(const Pf8i& a, const Pf8i& b) {return _mm256_add_epi32(a, b);}
+inline Pf8i operator-(const Pf8i& a, const Pf8i& b) {return _mm256_sub_epi32(a, b);}
+inline Pf8i operator*(const Pf8i& a, const Pf8i& b) {return _mm256_mullo_epi32(a, b);}
+inline Pf8i operator&(const Pf8i& a, const Pf8i& b) {return _mm256_and_si256(a, b);}
+inline Pf8i operator|(const Pf8i& a, const Pf8i& b) {return _mm256_or_si256(a, b);}
+inline Pf8i operator^(const Pf8i& a, const Pf8i& b) {return _mm256_xor_si256(a, b);}
+
+inline Pf8im operator&(const Pf8im& a, const Pf8im& b) {return _mm256_and_si256(a, b);}
+inline Pf8im operator|(const Pf8im& a, const Pf8im& b) {return _mm256_or_si256(a, b);}
+inline Pf8im operator~(const Pf8im& m)
+{
+  return _mm256_xor_si256(m, Pf8im(true));
+}
+
+inline bool any(const Pf8im& m) {return _mm256_movemask_ps(_mm256_castsi256_ps(m)) != 0;}
+inline bool all(const Pf8im& m) {return _mm256_movemask_ps(_mm256_castsi256_ps(m)) == 0xff;}
+
+inline Pf8im operator==(const Pf8i& a, const Pf8i& b) {return _mm256_cmpeq_epi32(a, b);}
+inline Pf8im operator> (const Pf8i& a, const Pf8i& b) {return _mm256_cmpgt_epi32(a, b);}
+inline Pf8im operator< (const Pf8i& a, const Pf8i& b) {return _mm256_cmpgt_epi32(b, a);}
+inline Pf8im operator!=(const Pf8i& a, const Pf8i& b) {return ~(a == b);}
+inline Pf8im operator<=(const Pf8i& a, const Pf8i& b) {return ~(a > b);}
+inline Pf8im operator>=(const Pf8i& a, const Pf8i& b) {return ~(a < b);}
+
+inline Pf8i blend(const Pf8im& m, const Pf8i& a, const Pf8i& b)
+{
+  return _mm256_blendv_epi8(b, a, m);
+}
+
+inline Pf8i min(const Pf8i& a, const Pf8i& b) {return _mm256_min_epi32(a, b);}
+inline Pf8i max(const Pf8i& a, const Pf8i& b) {return _mm256_max_epi32(a, b);}
+
+template <int I0, int I1, int I2, int I3> inline Pf8i shuffle(const Pf8i& v)
+{
+  return _mm256_shuffle_epi32(v, _MM_SHUFFLE(I3, I2, I1, I0));
+}
+
+inline int32_t reduce_add(const Pf8i& v)
+{
+  return reduce_add(Pf4i(_mm_add_epi32(_mm256_castsi256_si128(v),
+                                       _mm256_extracti128_si256(v, 1))));
+}
+
+inline int32_t reduce_min(const Pf8i& v)
+{
+  return reduce_min(Pf4i(_mm_min_epi32(_mm256_castsi256_si128(v),
+                                       _mm256_extracti128_si256(v, 1))));
+}
+
+inline int32_t reduce_max(const Pf8i& v)
+{
+  return reduce_max(Pf4i(_mm_max_epi32(_mm256_castsi256_si128(v),
+                                       _mm256_extracti128_si256(v, 1))));
+}
+
+#endif
+
+}
+
+#endif
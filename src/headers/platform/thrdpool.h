@@ -0,0 +1,280 @@
+#ifndef PLATFORM_THRDPOOL_H
+#define PLATFORM_THRDPOOL_H
+
+// ============================================================================================
+//
+// thrdpool.h -- Work-Stealing Thread Pools
+//
+// ============================================================================================
+
+/*
+A "pf::thread_pool" runs loops in parallel on a fixed set of worker threads:
+
+  #include <platform/thrdpool.h>
+
+  struct Scale
+  {
+    float* data;
+
+    void operator()(size_t first, size_t last) const
+    {
+      for (; first < last; first++)
+        data[first] *= 2;
+    }
+  };
+
+  struct Sum
+  {
+    const float* data;
+
+    double operator()(size_t first, size_t last) const {...}       // the sum of a subrange
+  };
+
+  struct Add
+  {
+    double operator()(double a, double b) const {return a + b;}
+  };
+
+  pf::thread_pool workers;                                            // one thread per CPU
+
+  workers.parallel_for(0, count, 4096, scale);
+  total = workers.parallel_reduce(0, count, 4096, 0.0, sum, add);
+
+"parallel_for()" calls "body(first, last)" for disjoint subranges that together cover
+["begin", "end"), none of them longer than "grain" items, and returns when every call has
+returned.  "parallel_reduce()" does the same with a body that returns a "T" for its subrange
+and combines the results (and "identity") with "join(a, b)", which must be associative and
+commutative:  the subranges are combined in no particular order, so a floating-point sum can
+differ slightly from one run to the next.  The grain size should be large enough that a
+subrange takes a few microseconds; smaller ones spend more time on scheduling than on work.
+C++11 lambdas can be used as bodies too.
+
+Each thread has a deque of tasks (a Chase-Lev deque).  A thread splits its range in half,
+pushes one half onto the bottom of its own deque and carries on with the other half until it
+has no more than "grain" items left; a thread whose deque is empty steals from the top of
+another thread's deque, which is where the largest ranges are.  There's no central queue for
+the threads to contend for, so a pool scales to as many threads as the computer has.  The
+thread that calls "parallel_for()" (or "parallel_reduce()") works too, and workers that have
+run out of work spin for a short while and then sleep until there's more.
+
+A body may call "parallel_for()" or "parallel_reduce()" on the same pool if the compiler
+supports thread-local variables.  Calls from threads other than the pool's workers are run one
+at a time.  A body mustn't throw an exception.
+
+If "PF_THREADS_API" is "PF_THREADS_NONE" (as it is when "PF_MULTITHREADED" is 0), or the pool
+was created with only one thread, then no worker threads are created and loops simply run on
+the calling thread, so the same code works in single-threaded programs.
+
+"src/code/thrdpool.cpp", "src/code/mutex.cpp", "src/code/pool.cpp", "src/code/alloc.cpp" and
+"src/code/affinity.cpp" must be compiled into the program.
+
+NOTE:  This header file requires a C++ compiler that supports namespaces and templates.
+*/
+
+// ============================================================================================
+// INCLUDE FILES
+// ============================================================================================
+
+#include <stddef.h>
+#include <new>
+
+#include <platform.h>
+#include <platform/align.h>
+#include <platform/alloc.h>
+#include <platform/atomic.h>
+#include <platform/mutex.h>
+#include <platform/pool.h>
+
+namespace pf
+{
+
+// ============================================================================================
+// CLASS DEFINITIONS
+// ============================================================================================
+
+class thread_pool
+{
+  public:
+    thread_pool(const unsigned threads = 0);
+    ~thread_pool();
+
+    unsigned size() const {return _size;}
+
+    template <class Body> void parallel_for(const size_t begin, const size_t end,
+                                            const size_t grain, const Body& body);
+
+    template <class T, class Body, class Join> T parallel_reduce(const size_t begin,
+                                                                 const size_t end,
+                                                                 const size_t grain,
+                                                                 const T& identity,
+                                                                 const Body& body,
+                                                                 const Join& join);
+
+  private:
+    struct job
+    {
+      void          (*call)(job*, const size_t, const size_t, const unsigned);   // runs a body
+      size_t        grain;                               // the largest subrange to run at once
+      pf_atomic64_t remaining;                               // the number of items not yet run
+      pf_atomic32_t done;                       // 0 = running, 1 = caller asleep, 2 = finished
+    };
+
+    template <class Body> struct for_job: job
+    {
+      const Body* body;
+
+      static void invoke(job* self, const size_t begin, const size_t end, const unsigned)
+      {
+        (*((for_job*)self)->body)(begin, end);
+      }
+    };
+
+    template <class T, class Body, class Join> struct reduce_job: job
+    {
+      const Body* body;
+      const Join* join;
+      padded<T>*  partials;                                      // a partial result per thread
+
+      static void invoke(job* self, const size_t begin, const size_t end, const unsigned slot)
+      {
+        reduce_job* const work  = (reduce_job*)self;
+        const T           value = (*work->body)(begin, end);     // may run other subranges too
+
+        *work->partials[slot] = (*work->join)(*work->partials[slot], value);
+      }
+    };
+
+    struct task
+    {
+      job*   work;                                                      // the job it's part of
+      size_t begin;                                                    // the first item to run
+      size_t end;                                                      // one past the last one
+    };
+
+    struct deque;
+
+    unsigned        _size;                       // the number of threads, including the caller
+    deque*          _deques;                                         // a deque for each thread
+    void*           _threads;                              // the workers' threads (or handles)
+    pool<task>      _tasks;                                                // the tasks' memory
+    pf_atomic_ptr_t _spareResults;              // a reduction's results memory, kept for reuse
+    adaptive_mutex  _callerLock;                   // held by a non-worker thread running a job
+    pf_atomic32_t   _epoch;                      // changed whenever sleeping workers are woken
+    pf_atomic32_t   _sleeping;                         // the number of workers (nearly) asleep
+    pf_atomic32_t   _stop;                               // non-zero when the workers must exit
+
+    void  run(job&, const size_t, const size_t);
+    void  execute(deque*, job*, size_t, size_t);
+    bool  findTask(deque*, task&);
+    void  wakeWorker();
+    void  workerLoop(deque*);
+    void  stopWorkers(const unsigned);
+    void* takeResults(const size_t);
+    void  giveResults(void*);
+
+    thread_pool(const thread_pool&);                                            // not copyable
+    thread_pool& operator=(const thread_pool&);
+};
+
+// ============================================================================================
+// INLINE FUNCTION DEFINITIONS
+// ============================================================================================
+
+/*********************************************************************************************/
+
+template <class Body> void thread_pool::parallel_for
+(
+  const size_t begin,                                                  // the first item to run
+  const size_t end,                                                    // one past the last one
+  const size_t grain,                                    // the largest subrange to run at once
+  const Body&  body                                   // called as "body(first, last)" for each
+)
+
+/*
+This function runs a loop in parallel.
+
+PRECONDITIONS:
+"begin" must be no greater than "end".
+
+POSTCONDITIONS:
+"body" has been called for disjoint subranges that cover ["begin", "end"), each no longer than
+"grain" items (or 1 if "grain" is 0).
+*/
+
+{
+  for_job<Body> work;
+
+  work.call  = &for_job<Body>::invoke;
+  work.grain = (grain > 0) ? grain : 1;
+  work.body  = &body;
+  run(work, begin, end);
+}
+
+/*********************************************************************************************/
+
+template <class T, class Body, class Join> T thread_pool::parallel_reduce
+(
+  const size_t begin,                                                  // the first item to run
+  const size_t end,                                                    // one past the last one
+  const size_t grain,                                    // the largest subrange to run at once
+  const T&     identity,                                       // the result for an empty range
+  const Body&  body,                                // returns the result for ["first", "last")
+  const Join&  join                                                     // combines two results
+)
+
+/*
+This function runs a reduction in parallel.
+
+PRECONDITIONS:
+"begin" must be no greater than "end", and "join" must be associative and commutative.
+
+POSTCONDITIONS:
+The results of calling "body" for disjoint subranges that cover ["begin", "end") (each no
+longer than "grain" items, or 1 if "grain" is 0) have been combined with "identity" by
+"join", and the combined result is returned.
+*/
+
+{
+  reduce_job<T, Body, Join> work;
+  T                         result = identity;
+  unsigned                  slot;
+
+  work.call     = &reduce_job<T, Body, Join>::invoke;
+  work.grain    = (grain > 0) ? grain : 1;
+  work.body     = &body;
+  work.join     = &join;
+  work.partials = (padded<T>*)takeResults(_size * sizeof(padded<T>));
+
+  if (work.partials == NULL)                                     // run it on this thread alone
+  {
+    size_t first = begin;
+
+    while (first < end)
+    {
+      const size_t last = (end - first > work.grain) ? first + work.grain : end;
+
+      result = join(result, body(first, last));
+      first  = last;
+    }
+
+    return result;
+  }
+
+  for (slot = 0; slot < _size; slot++)
+    new (&work.partials[slot]) padded<T>(identity);
+
+  run(work, begin, end);
+
+  for (slot = 0; slot < _size; slot++)
+  {
+    result = join(result, *work.partials[slot]);
+    work.partials[slot].~padded<T>();
+  }
+
+  giveResults(work.partials);
+  return result;
+}
+
+}
+
+#endif
@@ -4,7 +4,7 @@
 //
 // ============================================================================================
 
-#ifndef PLATFORM_H
+#ifndef PF_WATCOM
   #error platform.h has not been included yet.
 #endif
 
@@ -86,6 +86,11 @@ The following was taken from the help files of Watcom C++ 11O:
 
   NO_EXT_KEYS           The program is being compiled for ANSI/ISO conformance using the "za"
 			(no extended keywords) compiler option.
+
+  __SW_BM               The program is being compiled using the "bm" (multithreaded
+                        application) compiler option.
+
+  _MT                   The program is being compiled for a multithreaded environment.
 */
 
 #ifndef COMPILER_WATCOM_H
@@ -110,13 +115,20 @@ The following was taken from the help files of Watcom C++ 11O:
   #endif
 
   #if defined(_M_IX86)
-    #define PF_CPU PF_INTEL_80X86
+    #define PF_CPU    PF_INTEL_X86
+    #define PF_ENDIAN PF_ENDIAN_LITTLE
   #else
     #define PF_CPU PF_UNKNOWN_CPU
   #endif
 
   #define PF_STD_LIB_CALL   _cdecl
-  #define PF_MULTI_THREADED 0
+
+  #if defined(__SW_BM) || defined(_MT)
+    #define PF_MULTITHREADED 1
+  #else
+    #define PF_MULTITHREADED 0
+  #endif
+
   #define PF_DLL_IMPORT
   #define PF_DLL_EXPORT
   #define PF_DLL_CALL
@@ -2063,7 +2075,7 @@ The following was taken from the help files of Watcom C++ 11O:
   #define PF_INCLUDE_ONCE_ONLY                         once
   #define PF_REUSE_DUPLICATE_STRINGS_OFF               off (reuse_duplicate_strings);
   #define PF_REUSE_DUPLICATE_STRINGS_ON                on (reuse_duplicate_strings);
-  #define PF_TEMPLATE_RECURSIVE_EXPANSION_LIMIT(limit) template_depth n
+  #define PF_TEMPLATE_RECURSIVE_EXPANSION_LIMIT(limit) template_depth limit
 
 #endif
 